@@ -5,15 +5,40 @@
 // Topics covered:
 //   - Top-down mergesort (recursive)
 //   - Bottom-up mergesort (iterative)
+//   - Reduced-memory mergesort (n/2 aux, sqrt(n) buffer, in-place rotation)
+//   - Branchless and AVX2 bitonic-network merge kernels
+//   - Tuned hybrid sort entry points (quicksortTuned, parallelMergesortTuned,
+//     sortTuned) whose thresholds (insertion cutoff, parallel grain, radix
+//     crossover) come from a host autotuner: run with --autotune to write
+//     sort-tuning.txt
 //   - Quicksort with Lomuto partition scheme
 //   - Quicksort with Hoare partition scheme
 //   - Median-of-three pivot selection
+//   - Selection: introselect with Floyd-Rivest sampling, median-of-medians
+//     fallback, partial sort, top-k and multi-select (percentiles)
+//   - String sorts: 3-way string quicksort and MSD string radix sort
 //   - Demo showing sorted output for each algorithm
+//
+// Compile: g++ -std=c++17 -O2 -pthread [-mavx2] -o lecture-04 lecture-04-samples.cpp
+// Run:     ./lecture-04             (demo and benchmarks)
+//          ./lecture-04 --autotune  (measure sort thresholds, write sort-tuning.txt)
 // ============================================================================
 
 #include <iostream>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <cstdint>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <functional>
+#include <thread>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
@@ -28,6 +53,17 @@ void printArray(const vector<int>& arr, const string& label = "") {
     cout << "]\n";
 }
 
+// === SECTION: Helper -- Random Input ===
+// Simple LCG so every run (and every algorithm) sees the same input.
+vector<int> randomArray(int n, int maxVal, unsigned int seed = 42) {
+    vector<int> arr(n);
+    for (int i = 0; i < n; i++) {
+        seed = (seed * 1103515245u + 12345u) & 0x7fffffff;
+        arr[i] = (int)(seed % maxVal);
+    }
+    return arr;
+}
+
 // === SECTION: Top-Down Mergesort (Recursive) ===
 // Divide the array in half, recursively sort each half, then merge.
 // Guaranteed O(n log n) in all cases. Requires O(n) auxiliary space.
@@ -46,25 +82,30 @@ void merge(vector<int>& arr, vector<int>& aux, int lo, int mid, int hi) {
     }
 }
 
-void topDownSort(vector<int>& arr, vector<int>& aux, int lo, int hi) {
+// Any merge kernel with the same contract as merge() can be plugged in
+// (see mergeBranchless and mergeSIMD below).
+typedef void (*MergeFn)(vector<int>&, vector<int>&, int, int, int);
+
+void topDownSort(vector<int>& arr, vector<int>& aux, int lo, int hi,
+                 MergeFn mergeFn = merge) {
     if (hi <= lo) return;
     int mid = lo + (hi - lo) / 2;
-    topDownSort(arr, aux, lo, mid);       // sort left half
-    topDownSort(arr, aux, mid + 1, hi);   // sort right half
-    merge(arr, aux, lo, mid, hi);         // merge results
+    topDownSort(arr, aux, lo, mid, mergeFn);       // sort left half
+    topDownSort(arr, aux, mid + 1, hi, mergeFn);   // sort right half
+    mergeFn(arr, aux, lo, mid, hi);                // merge results
 }
 
-void mergesortTopDown(vector<int>& arr) {
+void mergesortTopDown(vector<int>& arr, MergeFn mergeFn = merge) {
     int n = (int)arr.size();
     vector<int> aux(n);
-    topDownSort(arr, aux, 0, n - 1);
+    topDownSort(arr, aux, 0, n - 1, mergeFn);
 }
 
 // === SECTION: Bottom-Up Mergesort (Iterative) ===
 // Merge subarrays of size 1, then 2, then 4, ... without recursion.
 // Same O(n log n) performance, avoids recursion overhead.
 
-void mergesortBottomUp(vector<int>& arr) {
+void mergesortBottomUp(vector<int>& arr, MergeFn mergeFn = merge) {
     int n = (int)arr.size();
     vector<int> aux(n);
 
@@ -74,11 +115,215 @@ void mergesortBottomUp(vector<int>& arr) {
         for (int lo = 0; lo < n - sz; lo += 2 * sz) {
             int mid = lo + sz - 1;
             int hi  = min(lo + 2 * sz - 1, n - 1);
-            merge(arr, aux, lo, mid, hi);
+            mergeFn(arr, aux, lo, mid, hi);
         }
     }
 }
 
+// === SECTION: Branchless and SIMD Merge Kernels ===
+// The comparison in merge() is a coin flip on random data, so the branch
+// predictor misses about half the time. Two alternatives with the same
+// contract as merge() (copy arr[lo..hi] to aux, merge back into arr):
+//
+// Branchless: compute both candidates and pick one with a conditional move;
+// the index updates become arithmetic on the comparison result.
+//
+// SIMD (AVX2, compile with -mavx2 or -march=native): merge 8 ints at a time.
+// Two sorted 8-lane vectors are merged by a bitonic network: reverse one,
+// take lane-wise min/max (the min vector holds the 8 smallest and both are
+// bitonic), then sort each with three min/max + shuffle stages. The min
+// vector is output; the max vector is carried into the next round together
+// with 8 more elements from whichever input has the smaller head.
+// Without AVX2, mergeSIMD is the branchless kernel.
+
+// Branchless merge of sorted runs a[0..na) and b[0..nb) into out.
+// Returns the number of elements written (na + nb).
+int mergeRunsBranchless(const int* a, int na, const int* b, int nb, int* out) {
+    int i = 0, j = 0, k = 0;
+    while (i < na && j < nb) {
+        int x = a[i], y = b[j];
+        bool takeRight = y < x;         // stable: ties go to the left run
+        out[k++] = takeRight ? y : x;   // compiles to a cmov
+        j += takeRight;
+        i += !takeRight;
+    }
+    while (i < na) out[k++] = a[i++];
+    while (j < nb) out[k++] = b[j++];
+    return k;
+}
+
+void mergeBranchless(vector<int>& arr, vector<int>& aux, int lo, int mid, int hi) {
+    for (int k = lo; k <= hi; k++) aux[k] = arr[k];
+    mergeRunsBranchless(&aux[lo], mid - lo + 1, &aux[mid + 1], hi - mid, &arr[lo]);
+}
+
+#ifdef __AVX2__
+// Sort a bitonic 8-lane vector into ascending order.
+static inline __m256i bitonicClean8(__m256i x) {
+    // Distance 4: compare lanes i and i+4
+    __m256i t  = _mm256_permute2x128_si256(x, x, 0x01);
+    x = _mm256_blend_epi32(_mm256_min_epi32(x, t), _mm256_max_epi32(x, t), 0xF0);
+    // Distance 2
+    t = _mm256_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2));
+    x = _mm256_blend_epi32(_mm256_min_epi32(x, t), _mm256_max_epi32(x, t), 0xCC);
+    // Distance 1
+    t = _mm256_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1));
+    x = _mm256_blend_epi32(_mm256_min_epi32(x, t), _mm256_max_epi32(x, t), 0xAA);
+    return x;
+}
+
+// Merge two sorted vectors: lo gets the 8 smallest, hi the 8 largest.
+static inline void bitonicMerge8x8(__m256i& lo, __m256i& hi) {
+    const __m256i reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    __m256i r = _mm256_permutevar8x32_epi32(hi, reverse);
+    __m256i mn = _mm256_min_epi32(lo, r);
+    __m256i mx = _mm256_max_epi32(lo, r);
+    lo = bitonicClean8(mn);
+    hi = bitonicClean8(mx);
+}
+
+int mergeRunsSIMD(const int* a, int na, const int* b, int nb, int* out) {
+    if (na < 8 || nb < 8) return mergeRunsBranchless(a, na, b, nb, out);
+
+    int i = 8, j = 8, k = 0;
+    __m256i va = _mm256_loadu_si256((const __m256i*)a);
+    __m256i vb = _mm256_loadu_si256((const __m256i*)b);
+    bitonicMerge8x8(va, vb);
+    _mm256_storeu_si256((__m256i*)out, va);
+    k = 8;
+
+    // vb carries the 8 largest seen so far; refill from the smaller head
+    while (i + 8 <= na && j + 8 <= nb) {
+        if (a[i] < b[j]) { va = _mm256_loadu_si256((const __m256i*)(a + i)); i += 8; }
+        else             { va = _mm256_loadu_si256((const __m256i*)(b + j)); j += 8; }
+        bitonicMerge8x8(va, vb);
+        _mm256_storeu_si256((__m256i*)(out + k), va);
+        k += 8;
+    }
+
+    // One input has fewer than 8 left. Merge the carry with that short tail
+    // (at most 15 ints), then merge the result with the other input's tail.
+    int carry[8], small[16];
+    _mm256_storeu_si256((__m256i*)carry, vb);
+    if (i + 8 > na) {
+        int ns = mergeRunsBranchless(a + i, na - i, carry, 8, small);
+        return k + mergeRunsBranchless(small, ns, b + j, nb - j, out + k);
+    }
+    int ns = mergeRunsBranchless(carry, 8, b + j, nb - j, small);
+    return k + mergeRunsBranchless(a + i, na - i, small, ns, out + k);
+}
+#else
+int mergeRunsSIMD(const int* a, int na, const int* b, int nb, int* out) {
+    return mergeRunsBranchless(a, na, b, nb, out);
+}
+#endif
+
+void mergeSIMD(vector<int>& arr, vector<int>& aux, int lo, int mid, int hi) {
+    for (int k = lo; k <= hi; k++) aux[k] = arr[k];
+    mergeRunsSIMD(&aux[lo], mid - lo + 1, &aux[mid + 1], hi - mid, &arr[lo]);
+}
+
+// === SECTION: Reduced-Memory Mergesort ===
+// merge() copies both halves, so mergesortTopDown needs n extra ints.
+//
+// Half-size aux: only the left half is copied out. Writing into arr[k] can
+// never overtake the read position j in the right half (k < j until the
+// left copy is exhausted), so the right half is merged in place. n/2 extra.
+//
+// Rotation merge: split the larger run at its middle, binary-search the
+// matching cut in the other run, rotate the two inner pieces so the cuts
+// meet, then merge both sides recursively. O(1) extra, O(n log n) per merge.
+// When one run fits in a small buffer (e.g. sqrt(n) ints) we switch to a
+// buffered merge, which removes most of the rotation cost.
+
+// Merge arr[lo..mid] and arr[mid+1..hi] using aux for the left half only.
+void mergeHalfAux(vector<int>& arr, vector<int>& aux, int lo, int mid, int hi) {
+    int n1 = mid - lo + 1;
+    for (int t = 0; t < n1; t++) aux[t] = arr[lo + t];
+
+    int i = 0, j = mid + 1, k = lo;
+    while (i < n1 && j <= hi) {
+        if (arr[j] < aux[i]) arr[k++] = arr[j++];  // right is smaller
+        else                 arr[k++] = aux[i++];  // left is smaller (stable)
+    }
+    while (i < n1) arr[k++] = aux[i++];  // leftover right elements are in place
+}
+
+// Same as mergeHalfAux but copies the right half and merges from the back.
+void mergeHalfAuxBackward(vector<int>& arr, vector<int>& aux, int lo, int mid, int hi) {
+    int n2 = hi - mid;
+    for (int t = 0; t < n2; t++) aux[t] = arr[mid + 1 + t];
+
+    int i = mid, j = n2 - 1, k = hi;
+    while (i >= lo && j >= 0) {
+        if (aux[j] < arr[i]) arr[k--] = arr[i--];  // left is larger
+        else                 arr[k--] = aux[j--];  // right is larger (stable)
+    }
+    while (j >= 0) arr[k--] = aux[j--];
+}
+
+// Merge arr[lo..mid] and arr[mid+1..hi] with a buffer of any size (even 0).
+void mergeRotate(vector<int>& arr, vector<int>& buf, int lo, int mid, int hi) {
+    int n1 = mid - lo + 1, n2 = hi - mid;
+    if (n1 == 0 || n2 == 0) return;
+    if (arr[mid] <= arr[mid + 1]) return;  // already in order
+    if (n1 <= (int)buf.size()) { mergeHalfAux(arr, buf, lo, mid, hi); return; }
+    if (n2 <= (int)buf.size()) { mergeHalfAuxBackward(arr, buf, lo, mid, hi); return; }
+    if (n1 + n2 == 2) { swap(arr[lo], arr[hi]); return; }
+
+    // cut1 splits the left run, cut2 the right run (both are exclusive ends)
+    auto base = arr.begin();
+    int cut1, cut2;
+    if (n1 > n2) {
+        cut1 = lo + n1 / 2;
+        cut2 = (int)(lower_bound(base + mid + 1, base + hi + 1, arr[cut1]) - base);
+    } else {
+        cut2 = mid + 1 + n2 / 2;
+        cut1 = (int)(upper_bound(base + lo, base + mid + 1, arr[cut2]) - base);
+    }
+    // [cut1..mid] and [mid+1..cut2-1] swap places
+    rotate(base + cut1, base + mid + 1, base + cut2);
+    int newMid = cut1 + (cut2 - (mid + 1));  // first element of the old left tail
+    mergeRotate(arr, buf, lo, cut1 - 1, newMid - 1);
+    mergeRotate(arr, buf, newMid, cut2 - 1, hi);
+}
+
+void halfAuxSort(vector<int>& arr, vector<int>& aux, int lo, int hi) {
+    if (hi <= lo) return;
+    int mid = lo + (hi - lo) / 2;
+    halfAuxSort(arr, aux, lo, mid);
+    halfAuxSort(arr, aux, mid + 1, hi);
+    if (arr[mid] > arr[mid + 1]) mergeHalfAux(arr, aux, lo, mid, hi);
+}
+
+void rotateSort(vector<int>& arr, vector<int>& buf, int lo, int hi) {
+    if (hi <= lo) return;
+    int mid = lo + (hi - lo) / 2;
+    rotateSort(arr, buf, lo, mid);
+    rotateSort(arr, buf, mid + 1, hi);
+    mergeRotate(arr, buf, lo, mid, hi);
+}
+
+// n/2 extra ints, same speed class as mergesortTopDown.
+void mergesortHalfAux(vector<int>& arr) {
+    int n = (int)arr.size();
+    vector<int> aux((n + 1) / 2);
+    halfAuxSort(arr, aux, 0, n - 1);
+}
+
+// sqrt(n) extra ints: buffered merges near the leaves, rotations above.
+void mergesortSqrtBuffer(vector<int>& arr) {
+    int n = (int)arr.size();
+    vector<int> buf((int)sqrt((double)n) + 1);
+    rotateSort(arr, buf, 0, n - 1);
+}
+
+// O(1) extra space (plus O(log n) recursion stack). O(n log^2 n) time.
+void mergesortInPlace(vector<int>& arr) {
+    vector<int> none;
+    rotateSort(arr, none, 0, (int)arr.size() - 1);
+}
+
 // === SECTION: Quicksort with Lomuto Partition ===
 // Lomuto: pivot is the last element. Partition into [<=pivot | pivot | >pivot].
 // Simple to understand but does more swaps than Hoare on average.
@@ -174,6 +419,515 @@ void quicksortMedian3(vector<int>& arr, int lo, int hi) {
     quicksortMedian3(arr, p + 1, hi);
 }
 
+// === SECTION: Selection (k-th Smallest) with Introselect ===
+// Quickselect partitions like quicksort but only recurses into the side that
+// contains index k, so the expected cost is O(n) instead of O(n log n).
+// Built on hoarePartition (pivot at arr[lo]); after each step every element
+// of arr[lo..j] is <= every element of arr[j+1..hi], so we keep one side.
+//
+// Pivot choice:
+//   - Floyd-Rivest: for large ranges, recursively select k inside a small
+//     sample around the expected position of k. The pivot then lands very
+//     close to k and the range shrinks to O(n^(2/3)) in one step.
+//   - Median-of-medians: the partition passes are charged their length, and
+//     once the total exceeds 3n (input whose pivots keep shrinking the
+//     range by only a few elements), switch to the guaranteed-linear pivot.
+//     At most 3n work is spent before the switch and O(n) after it, so the
+//     worst case is linear.
+
+const int SELECT_CUTOFF = 16;    // insertion-sort ranges smaller than this
+const int FR_SAMPLE_MIN = 600;   // use Floyd-Rivest sampling above this size
+
+// Insertion sort on arr[lo..hi], used for small ranges.
+void insertionSortRange(vector<int>& arr, int lo, int hi) {
+    for (int i = lo + 1; i <= hi; i++) {
+        int key = arr[i];
+        int j = i - 1;
+        while (j >= lo && arr[j] > key) {
+            arr[j + 1] = arr[j];
+            j--;
+        }
+        arr[j + 1] = key;
+    }
+}
+
+void selectLinear(vector<int>& arr, int lo, int hi, int k);
+
+// Median-of-medians pivot: sort groups of 5, move each group median to the
+// front of the range, then select the median of those medians.
+// Returns the index of the pivot. Guarantees ~30% of the range on each side.
+int medianOfMedians(vector<int>& arr, int lo, int hi) {
+    if (hi - lo < 5) {
+        insertionSortRange(arr, lo, hi);
+        return lo + (hi - lo) / 2;
+    }
+    int m = lo;  // medians are collected in arr[lo..m-1]
+    for (int g = lo; g <= hi; g += 5) {
+        int gHi = min(g + 4, hi);
+        insertionSortRange(arr, g, gHi);
+        swap(arr[m++], arr[g + (gHi - g) / 2]);
+    }
+    int mid = lo + (m - 1 - lo) / 2;
+    selectLinear(arr, lo, m - 1, mid);
+    return mid;
+}
+
+// Worst-case O(n) selection: median-of-medians pivot at every step.
+void selectLinear(vector<int>& arr, int lo, int hi, int k) {
+    while (hi > lo) {
+        if (hi - lo < SELECT_CUTOFF) { insertionSortRange(arr, lo, hi); return; }
+        int p = medianOfMedians(arr, lo, hi);
+        swap(arr[lo], arr[p]);
+        int j = hoarePartition(arr, lo, hi);
+        if (k <= j) hi = j;
+        else        lo = j + 1;
+    }
+}
+
+// Introselect on arr[lo..hi]: Floyd-Rivest / median-of-three pivots, with a
+// work budget of 3n partitioned elements before falling back to selectLinear.
+void selectRange(vector<int>& arr, int lo, int hi, int k) {
+    long long budget = 3LL * (hi - lo + 1);
+    while (hi > lo) {
+        if (hi - lo < SELECT_CUTOFF) { insertionSortRange(arr, lo, hi); return; }
+        budget -= hi - lo + 1;          // this step partitions the whole range
+        if (budget < 0) { selectLinear(arr, lo, hi, k); return; }
+
+        if (hi - lo > FR_SAMPLE_MIN) {
+            // Floyd-Rivest: select k within a sample [newLo, newHi] sized
+            // ~n^(2/3) and biased toward where k is expected to fall.
+            double n  = hi - lo + 1;
+            double i  = k - lo + 1;
+            double z  = log(n);
+            double s  = 0.5 * exp(2.0 * z / 3.0);
+            double sd = 0.5 * sqrt(z * s * (n - s) / n) * (i < n / 2 ? -1 : 1);
+            int newLo = max(lo, (int)(k - i * s / n + sd));
+            int newHi = min(hi, (int)(k + (n - i) * s / n + sd));
+            selectRange(arr, newLo, newHi, k);
+            swap(arr[lo], arr[k]);  // hoarePartition takes its pivot from lo
+        } else {
+            int mid = lo + (hi - lo) / 2;
+            // Median of lo, mid, hi moved to lo
+            if (arr[mid] < arr[lo])  swap(arr[mid], arr[lo]);
+            if (arr[hi]  < arr[lo])  swap(arr[hi], arr[lo]);
+            if (arr[hi]  < arr[mid]) swap(arr[hi], arr[mid]);
+            swap(arr[lo], arr[mid]);
+        }
+
+        int j = hoarePartition(arr, lo, hi);
+        if (k <= j) hi = j;
+        else        lo = j + 1;
+    }
+}
+
+// Rearranges arr so arr[k] is the k-th smallest (0-based), everything before
+// it is <= arr[k] and everything after is >= arr[k]. Returns arr[k].
+int select(vector<int>& arr, int k) {
+    selectRange(arr, 0, (int)arr.size() - 1, k);
+    return arr[k];
+}
+
+// Sorts only the k smallest elements into arr[0..k-1]; the rest of the array
+// is left in unspecified order. O(n + k log k).
+void partialSort(vector<int>& arr, int k) {
+    if (k <= 0) return;
+    if (k > (int)arr.size()) k = (int)arr.size();
+    selectRange(arr, 0, (int)arr.size() - 1, k - 1);
+    quicksortMedian3(arr, 0, k - 2);  // arr[k-1] is already in place
+}
+
+// Returns the k largest elements in descending order. Reorders arr.
+vector<int> topK(vector<int>& arr, int k) {
+    int n = (int)arr.size();
+    if (k <= 0) return {};
+    if (k > n) k = n;
+    selectRange(arr, 0, n - 1, n - k);
+    quicksortMedian3(arr, n - k + 1, n - 1);  // arr[n-k] is already in place
+    return vector<int>(arr.rbegin(), arr.rbegin() + k);
+}
+
+// === SECTION: Multi-Select (Several Order Statistics at Once) ===
+// Select the middle requested rank first; that partitions the range, so the
+// smaller ranks only search the left part and the larger ranks only the
+// right part. m ranks cost O(n log m) instead of m separate O(n) selects.
+
+void multiSelectRange(vector<int>& arr, int lo, int hi,
+                      const vector<int>& ks, int kLo, int kHi) {
+    if (kLo >= kHi || lo >= hi) return;
+    int mid = kLo + (kHi - kLo) / 2;
+    int k = ks[mid];
+    selectRange(arr, lo, hi, k);
+    multiSelectRange(arr, lo, k - 1, ks, kLo, mid);
+    multiSelectRange(arr, k + 1, hi, ks, mid + 1, kHi);
+}
+
+// Places every rank in ks at its sorted position. Returns the selected values
+// in the same order as ks.
+vector<int> multiSelect(vector<int>& arr, vector<int> ks) {
+    vector<int> sortedKs = ks;
+    sort(sortedKs.begin(), sortedKs.end());
+    sortedKs.erase(unique(sortedKs.begin(), sortedKs.end()), sortedKs.end());
+    multiSelectRange(arr, 0, (int)arr.size() - 1, sortedKs, 0, (int)sortedKs.size());
+    for (int& k : ks) k = arr[k];
+    return ks;
+}
+
+// Percentiles in [0, 1] (e.g. 0.5, 0.9, 0.99) using nearest-rank on n-1.
+vector<int> percentiles(vector<int>& arr, const vector<double>& ps) {
+    vector<int> ks;
+    for (double p : ps) ks.push_back((int)(p * ((int)arr.size() - 1)));
+    return multiSelect(arr, ks);
+}
+
+// === SECTION: Tuned Sort Thresholds ===
+// Hybrid sorts switch strategy at thresholds whose best values depend on the
+// machine (cache sizes, branch predictor, core count):
+//   - insertionCutoff: subarrays smaller than this are insertion-sorted
+//   - parallelGrain:   subarrays larger than this are sorted on a new thread
+//   - radixCrossover:  arrays at least this large use LSD radix sort
+// The values are read from sort-tuning.txt at startup (written by running
+// this program with --autotune). Without a profile the defaults below apply.
+// Only the hybrid entry points in the next section read them; the textbook
+// sorts elsewhere in this file stay cutoff-free so their traces match the
+// lecture.
+
+const char* SORT_PROFILE_PATH = "sort-tuning.txt";
+
+struct SortTuning {
+    int insertionCutoff = 16;
+    int parallelGrain   = 1 << 16;
+    int radixCrossover  = 1 << 10;
+    string source = "compiled-in defaults";
+};
+
+// Reads "key value" lines; '#' starts a comment. Unknown keys and
+// non-positive values are skipped with a warning, so a damaged profile
+// degrades to defaults. source names the file only if a value was applied.
+SortTuning loadSortTuning(const string& path = SORT_PROFILE_PATH) {
+    SortTuning t;
+    ifstream in(path);
+    if (!in) return t;
+
+    string line;
+    int lineNo = 0, applied = 0;
+    while (getline(in, line)) {
+        lineNo++;
+        if (line.empty() || line[0] == '#') continue;
+        istringstream fields(line);
+        string key;
+        long long value;
+        if (!(fields >> key >> value) || value <= 0 || value > INT32_MAX) {
+            cerr << path << ":" << lineNo << ": bad line ignored: " << line << "\n";
+            continue;
+        }
+        if      (key == "insertionCutoff") t.insertionCutoff = (int)value;
+        else if (key == "parallelGrain")   t.parallelGrain   = (int)value;
+        else if (key == "radixCrossover")  t.radixCrossover  = (int)value;
+        else {
+            cerr << path << ":" << lineNo << ": unknown key ignored: " << key << "\n";
+            continue;
+        }
+        applied++;
+    }
+    if (applied > 0) t.source = path;
+    return t;
+}
+
+bool saveSortTuning(const SortTuning& t, const string& path = SORT_PROFILE_PATH) {
+    ofstream out(path);
+    if (!out) return false;
+    out << "# Sort thresholds for this host (written by --autotune)\n";
+    out << "insertionCutoff " << t.insertionCutoff << "\n";
+    out << "parallelGrain "   << t.parallelGrain   << "\n";
+    out << "radixCrossover "  << t.radixCrossover  << "\n";
+    return (bool)out;
+}
+
+SortTuning sortTuning = loadSortTuning();  // loaded once, before main()
+
+// === SECTION: Tuned Hybrid Sorts ===
+
+// Median-of-three quicksort that insertion-sorts small subarrays and
+// recurses on the smaller side only (O(log n) stack).
+void quicksortCutoff(vector<int>& arr, int lo, int hi, int cutoff) {
+    while (hi - lo + 1 > cutoff && hi > lo) {
+        int p = medianOfThreePartition(arr, lo, hi);
+        if (p - lo < hi - p) { quicksortCutoff(arr, lo, p - 1, cutoff); lo = p + 1; }
+        else                 { quicksortCutoff(arr, p + 1, hi, cutoff); hi = p - 1; }
+    }
+    insertionSortRange(arr, lo, hi);
+}
+
+// LSD radix sort on 8-bit digits; the sign bit is flipped so negative
+// numbers order before positive ones. 4 passes, n extra ints.
+void radixSortLSD(vector<int>& arr) {
+    int n = (int)arr.size();
+    vector<unsigned int> a(n), aux(n);
+    for (int i = 0; i < n; i++) a[i] = (unsigned int)arr[i] ^ 0x80000000u;
+
+    for (int shift = 0; shift < 32; shift += 8) {
+        int count[257] = {0};
+        for (int i = 0; i < n; i++) count[((a[i] >> shift) & 0xFF) + 1]++;
+        for (int r = 0; r < 256; r++) count[r + 1] += count[r];
+        for (int i = 0; i < n; i++) aux[count[(a[i] >> shift) & 0xFF]++] = a[i];
+        a.swap(aux);
+    }
+    for (int i = 0; i < n; i++) arr[i] = (int)(a[i] ^ 0x80000000u);
+}
+
+// Top-down mergesort that forks a thread for the left half while the range
+// is larger than grain, up to 'depth' levels (about lg of the core count).
+void parallelMergesortRange(vector<int>& arr, vector<int>& aux, int lo, int hi,
+                            int grain, int cutoff, int depth) {
+    if (hi - lo + 1 <= cutoff) { insertionSortRange(arr, lo, hi); return; }
+    int mid = lo + (hi - lo) / 2;
+    if (hi - lo + 1 > grain && depth > 0) {
+        thread left(parallelMergesortRange, ref(arr), ref(aux), lo, mid,
+                    grain, cutoff, depth - 1);
+        parallelMergesortRange(arr, aux, mid + 1, hi, grain, cutoff, depth - 1);
+        left.join();
+    } else {
+        parallelMergesortRange(arr, aux, lo, mid, grain, cutoff, 0);
+        parallelMergesortRange(arr, aux, mid + 1, hi, grain, cutoff, 0);
+    }
+    if (arr[mid] > arr[mid + 1]) merge(arr, aux, lo, mid, hi);
+}
+
+void parallelMergesort(vector<int>& arr, int grain, int cutoff) {
+    int n = (int)arr.size();
+    vector<int> aux(n);
+    int depth = (int)ceil(log2((double)max(1u, thread::hardware_concurrency()))) + 1;
+    parallelMergesortRange(arr, aux, 0, n - 1, grain, cutoff, depth);
+}
+
+// Hybrid entry points that use the loaded profile.
+void quicksortTuned(vector<int>& arr) {
+    quicksortCutoff(arr, 0, (int)arr.size() - 1, sortTuning.insertionCutoff);
+}
+
+void parallelMergesortTuned(vector<int>& arr) {
+    parallelMergesort(arr, sortTuning.parallelGrain, sortTuning.insertionCutoff);
+}
+
+void sortTuned(vector<int>& arr) {
+    if ((int)arr.size() >= sortTuning.radixCrossover) radixSortLSD(arr);
+    else quicksortTuned(arr);
+}
+
+// === SECTION: Host Autotuner ===
+// Times each candidate threshold on this machine (best of 3 runs) and keeps
+// the fastest. Every candidate sorts the same input.
+
+double bestOfThreeMs(const vector<int>& input, const function<void(vector<int>&)>& sortFn) {
+    double best = 1e30;
+    for (int run = 0; run < 3; run++) {
+        vector<int> a = input;
+        auto start = chrono::high_resolution_clock::now();
+        sortFn(a);
+        auto end = chrono::high_resolution_clock::now();
+        best = min(best, chrono::duration<double, milli>(end - start).count());
+    }
+    return best;
+}
+
+SortTuning autotuneSorts() {
+    SortTuning t;
+    t.source = "autotune";
+
+    // Insertion-sort cutoff for quicksort
+    cout << "  insertionCutoff:";
+    vector<int> input = randomArray(200000, 1 << 30, 11);
+    double bestMs = 1e30;
+    for (int c : {1, 4, 8, 12, 16, 24, 32, 48, 64}) {
+        double msC = bestOfThreeMs(input, [c](vector<int>& a) {
+            quicksortCutoff(a, 0, (int)a.size() - 1, c);
+        });
+        cout << " " << c << "=" << msC << "ms";
+        if (msC < bestMs) { bestMs = msC; t.insertionCutoff = c; }
+    }
+    cout << "\n    -> " << t.insertionCutoff << "\n";
+
+    // Radix vs comparison crossover: the first size from which radix sort
+    // wins twice in a row. Each sample sorts ~1M elements in chunks of n.
+    cout << "  radixCrossover:";
+    t.radixCrossover = INT32_MAX;  // never use radix unless it wins
+    vector<int> batch = randomArray(1 << 20, 1 << 30, 13);
+    int cutoff = t.insertionCutoff;
+    int firstWin = 0;
+    for (int n = 32; n <= (1 << 16); n *= 2) {
+        auto perChunk = [n](const function<void(vector<int>&)>& fn) {
+            return [n, fn](vector<int>& a) {
+                vector<int> chunk(n);
+                for (int off = 0; off + n <= (int)a.size(); off += n) {
+                    copy(a.begin() + off, a.begin() + off + n, chunk.begin());
+                    fn(chunk);
+                }
+            };
+        };
+        double cmpMs = bestOfThreeMs(batch, perChunk([cutoff](vector<int>& a) {
+            quicksortCutoff(a, 0, (int)a.size() - 1, cutoff);
+        }));
+        double radMs = bestOfThreeMs(batch, perChunk(radixSortLSD));
+        bool radixWins = radMs < cmpMs;
+        cout << " " << n << "=" << (radixWins ? "radix" : "cmp");
+        if (!radixWins)         firstWin = 0;
+        else if (firstWin == 0) firstWin = n;
+        else { t.radixCrossover = firstWin; break; }
+    }
+    cout << "\n    -> " << t.radixCrossover << "\n";
+
+    // Parallel grain size for the threaded mergesort
+    cout << "  parallelGrain (" << thread::hardware_concurrency() << " hw threads):";
+    input = randomArray(2000000, 1 << 30, 17);
+    bestMs = 1e30;
+    for (int g : {1 << 12, 1 << 14, 1 << 16, 1 << 18, 1 << 20, 1 << 22}) {
+        double msG = bestOfThreeMs(input, [g, cutoff](vector<int>& a) {
+            parallelMergesort(a, g, cutoff);
+        });
+        cout << " " << g << "=" << msG << "ms";
+        if (msG < bestMs) { bestMs = msG; t.parallelGrain = g; }
+    }
+    cout << "\n    -> " << t.parallelGrain << "\n";
+    return t;
+}
+
+// === SECTION: String Sorts ===
+// Comparing two strings costs O(length of common prefix), and a comparison
+// sort repeats that work at every level. Both sorts below look at one
+// character position d at a time and never re-examine the prefix [0, d).
+//
+// 3-way string quicksort (Bentley-Sedgewick multikey quicksort): same shape
+// as quicksortMedian3, but the pivot is the median-of-three *character* at
+// position d, and the partition is 3-way: [< v | == v | > v]. Only the
+// middle part advances to d+1.
+//
+// MSD radix sort: counting-sort on the character at d (256 buckets plus one
+// for "string ended"), then sort each bucket on d+1.
+//
+// Small subarrays use an insertion sort that caches the next 8 characters
+// from position d as one 64-bit key, so most compares are a single integer
+// compare and the strings themselves are only touched on a key tie.
+
+const int STRING_CUTOFF = 24;  // insertion-sort subarrays smaller than this
+
+// Character at position d, or -1 past the end (shorter strings sort first).
+inline int charAt(string_view s, int d) {
+    return d < (int)s.size() ? (unsigned char)s[d] : -1;
+}
+
+// Next 8 characters from position d packed big-endian, zero-padded.
+inline uint64_t prefixKey(string_view s, int d) {
+    uint64_t key = 0;
+    for (int t = 0; t < 8; t++) {
+        key <<= 8;
+        if (d + t < (int)s.size()) key |= (unsigned char)s[d + t];
+    }
+    return key;
+}
+
+// Insertion sort of a[lo..hi], all of which share the prefix [0, d).
+template <typename Str>
+void insertionSortCached(vector<Str>& a, int lo, int hi, int d) {
+    int n = hi - lo + 1;
+    if (n < 2) return;
+    uint64_t key[STRING_CUTOFF];
+    int order[STRING_CUTOFF];
+    for (int t = 0; t < n; t++) { key[t] = prefixKey(a[lo + t], d); order[t] = t; }
+
+    auto less = [&](int x, int y) {
+        if (key[x] != key[y]) return key[x] < key[y];
+        string_view sx = a[lo + x], sy = a[lo + y];
+        // Keys tie: compare the rest, starting where the key stopped
+        int from = d + 8;
+        string_view rx = from < (int)sx.size() ? sx.substr(from) : string_view();
+        string_view ry = from < (int)sy.size() ? sy.substr(from) : string_view();
+        // Zero padding hides length differences ("ab" vs "ab\0"), so when
+        // both rests are empty fall back to the lengths
+        if (rx.empty() && ry.empty()) return sx.size() < sy.size();
+        return rx < ry;
+    };
+    for (int i = 1; i < n; i++) {
+        int v = order[i], j = i - 1;
+        while (j >= 0 && less(v, order[j])) { order[j + 1] = order[j]; j--; }
+        order[j + 1] = v;
+    }
+
+    // Apply the permutation
+    Str tmp[STRING_CUTOFF];
+    for (int t = 0; t < n; t++) tmp[t] = std::move(a[lo + order[t]]);
+    for (int t = 0; t < n; t++) a[lo + t] = std::move(tmp[t]);
+}
+
+void quick3String(vector<string>& a, int lo, int hi, int d) {
+    if (hi - lo + 1 < STRING_CUTOFF) { insertionSortCached(a, lo, hi, d); return; }
+
+    // Median-of-three on the character at d, moved to a[lo] as the pivot
+    int mid = lo + (hi - lo) / 2;
+    if (charAt(a[mid], d) < charAt(a[lo], d))  swap(a[lo], a[mid]);
+    if (charAt(a[hi], d)  < charAt(a[lo], d))  swap(a[lo], a[hi]);
+    if (charAt(a[hi], d)  < charAt(a[mid], d)) swap(a[mid], a[hi]);
+    swap(a[lo], a[mid]);
+
+    // 3-way partition: a[lo..lt-1] < v, a[lt..gt] == v, a[gt+1..hi] > v
+    int v = charAt(a[lo], d);
+    int lt = lo, gt = hi, i = lo + 1;
+    while (i <= gt) {
+        int c = charAt(a[i], d);
+        if      (c < v) swap(a[lt++], a[i++]);
+        else if (c > v) swap(a[i], a[gt--]);
+        else            i++;
+    }
+
+    quick3String(a, lo, lt - 1, d);
+    if (v >= 0) quick3String(a, lt, gt, d + 1);  // v < 0: all ended, all equal
+    quick3String(a, gt + 1, hi, d);
+}
+
+void quick3String(vector<string>& a) {
+    quick3String(a, 0, (int)a.size() - 1, 0);
+}
+
+// MSD radix sort of a[lo..hi] on character d. Works for string (elements
+// are moved, not copied) and for string_view.
+template <typename Str>
+void msdSort(vector<Str>& a, vector<Str>& aux, int lo, int hi, int d) {
+    if (hi - lo + 1 < STRING_CUTOFF) { insertionSortCached(a, lo, hi, d); return; }
+
+    // count[c + 2] = frequency of character c (c = -1 means "ended")
+    int count[256 + 2] = {0};
+    for (int i = lo; i <= hi; i++) count[charAt(a[i], d) + 2]++;
+    for (int r = 0; r < 256 + 1; r++) count[r + 1] += count[r];
+    for (int i = lo; i <= hi; i++) aux[count[charAt(a[i], d) + 1]++] = std::move(a[i]);
+    for (int i = lo; i <= hi; i++) a[i] = std::move(aux[i - lo]);
+
+    // count[r] is now the start of bucket r (bucket 0 = ended, already sorted)
+    for (int r = 0; r < 256; r++)
+        msdSort(a, aux, lo + count[r], lo + count[r + 1] - 1, d + 1);
+}
+
+template <typename Str>
+void msdRadixSort(vector<Str>& a) {
+    vector<Str> aux(a.size());
+    msdSort(a, aux, 0, (int)a.size() - 1, 0);
+}
+
+// Packs all strings into one contiguous arena and returns views into it.
+// Sorting the views moves 16-byte handles instead of strings, and the
+// characters at depth d of neighbouring keys stay close together in memory.
+vector<string_view> buildArena(const vector<string>& keys, string& arena) {
+    size_t total = 0;
+    for (const string& k : keys) total += k.size();
+    arena.clear();
+    arena.reserve(total);  // views must not be invalidated by reallocation
+    vector<string_view> views;
+    views.reserve(keys.size());
+    for (const string& k : keys) {
+        views.emplace_back(arena.data() + arena.size(), k.size());
+        arena += k;
+    }
+    return views;
+}
+
 // === SECTION: Partition Trace ===
 // Shows one level of Lomuto partitioning for educational purposes.
 void partitionTrace(vector<int> arr) {
@@ -201,7 +955,18 @@ void partitionTrace(vector<int> arr) {
 }
 
 // === MAIN ===
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 1 && string(argv[1]) == "--autotune") {
+        cout << "Autotuning sort thresholds for this host...\n";
+        SortTuning t = autotuneSorts();
+        if (!saveSortTuning(t)) {
+            cout << "Could not write " << SORT_PROFILE_PATH << "\n";
+            return 1;
+        }
+        cout << "Saved profile to " << SORT_PROFILE_PATH << "\n";
+        return 0;
+    }
+
     cout << "==========================================\n";
     cout << " Lecture 04: Mergesort and Quicksort\n";
     cout << "==========================================\n";
@@ -222,6 +987,16 @@ int main() {
     mergesortBottomUp(a2);
     printArray(a2, "Sorted");
 
+    // --- Reduced-Memory Mergesort ---
+    cout << "\n--- Reduced-Memory Mergesort ---\n";
+    vector<int> m1 = original, m2 = original, m3 = original;
+    mergesortHalfAux(m1);
+    mergesortSqrtBuffer(m2);
+    mergesortInPlace(m3);
+    printArray(m1, "Half-size aux (n/2)");
+    printArray(m2, "sqrt(n) buffer     ");
+    printArray(m3, "In-place rotation  ");
+
     // --- Quicksort (Lomuto) ---
     cout << "\n--- Quicksort (Lomuto Partition) ---\n";
     vector<int> a3 = original;
@@ -243,6 +1018,222 @@ int main() {
     quicksortMedian3(a5, 0, (int)a5.size() - 1);
     printArray(a5, "Sorted");
 
+    // --- Selection ---
+    cout << "\n--- Selection (Introselect / Floyd-Rivest) ---\n";
+    vector<int> q = original;
+    printArray(q, "Input");
+    for (int k = 0; k < (int)original.size(); k++) {
+        vector<int> t = original;
+        cout << "  " << k << "-th smallest: " << select(t, k) << "\n";
+    }
+    vector<int> p1 = {15, 3, 9, 8, 5, 2, 7, 1, 6, 12, 4};
+    partialSort(p1, 4);
+    printArray(p1, "partialSort(k=4)");
+    vector<int> p2 = {15, 3, 9, 8, 5, 2, 7, 1, 6, 12, 4};
+    printArray(topK(p2, 3), "topK(k=3)");
+
+    // --- Selection vs full sort on a large array ---
+    cout << "\n--- Selection vs Full Sort (n=1,000,000) ---\n";
+    const int N = 1000000;
+    vector<int> big = randomArray(N, 10000000);
+
+    vector<int> b1 = big;
+    auto t0 = chrono::high_resolution_clock::now();
+    quicksortMedian3(b1, 0, N - 1);
+    auto t1 = chrono::high_resolution_clock::now();
+
+    vector<int> b2 = big;
+    auto t2 = chrono::high_resolution_clock::now();
+    int median = select(b2, N / 2);
+    auto t3 = chrono::high_resolution_clock::now();
+
+    vector<int> b3 = big;
+    auto t4 = chrono::high_resolution_clock::now();
+    vector<int> top = topK(b3, 10);
+    auto t5 = chrono::high_resolution_clock::now();
+
+    vector<int> b4 = big;
+    auto t6 = chrono::high_resolution_clock::now();
+    vector<int> pct = percentiles(b4, {0.5, 0.9, 0.99, 0.999});
+    auto t7 = chrono::high_resolution_clock::now();
+
+    // Adversarial-looking input: already sorted, many duplicates
+    vector<int> b5(N);
+    for (int i = 0; i < N; i++) b5[i] = i / 1000;
+    auto t8 = chrono::high_resolution_clock::now();
+    int dupMedian = select(b5, N / 2);
+    auto t9 = chrono::high_resolution_clock::now();
+
+    auto ms = [](auto a, auto b) {
+        return chrono::duration_cast<chrono::microseconds>(b - a).count() / 1000.0;
+    };
+    cout << "  Full quicksort (median-of-3):   " << ms(t0, t1) << " ms\n";
+    cout << "  select(n/2):                    " << ms(t2, t3) << " ms"
+         << "  median=" << median
+         << (median == b1[N / 2] ? " (correct)" : " (WRONG)") << "\n";
+    cout << "  topK(10):                       " << ms(t4, t5) << " ms"
+         << "  max=" << top[0]
+         << (top[0] == b1[N - 1] && top[9] == b1[N - 10] ? " (correct)" : " (WRONG)")
+         << "\n";
+    cout << "  percentiles(50/90/99/99.9):     " << ms(t6, t7) << " ms  [";
+    bool pctOk = true;
+    int ranks[] = {(int)(0.5 * (N - 1)), (int)(0.9 * (N - 1)),
+                   (int)(0.99 * (N - 1)), (int)(0.999 * (N - 1))};
+    for (int i = 0; i < 4; i++) {
+        if (i > 0) cout << ", ";
+        cout << pct[i];
+        pctOk = pctOk && pct[i] == b1[ranks[i]];
+    }
+    cout << "]" << (pctOk ? " (correct)" : " (WRONG)") << "\n";
+    cout << "  select(n/2) on sorted dups:     " << ms(t8, t9) << " ms"
+         << "  median=" << dupMedian << "\n";
+
+    // --- Mergesort speed vs memory ---
+    cout << "\n--- Mergesort Speed vs Extra Memory (n=1,000,000) ---\n";
+    struct MergeVariant {
+        string name;
+        void (*sortFn)(vector<int>&);
+        long long extraInts;
+    };
+    vector<MergeVariant> variants = {
+        {"Top-down (full aux)  ", [](vector<int>& a) { mergesortTopDown(a); }, N},
+        {"Half-size aux        ", mergesortHalfAux,    (N + 1) / 2},
+        {"sqrt(n) buffer       ", mergesortSqrtBuffer, (long long)sqrt((double)N) + 1},
+        {"In-place rotation    ", mergesortInPlace,    0},
+    };
+    for (auto& v : variants) {
+        vector<int> b = big;
+        auto start = chrono::high_resolution_clock::now();
+        v.sortFn(b);
+        auto end = chrono::high_resolution_clock::now();
+        cout << "  " << v.name << ms(start, end) << " ms, extra "
+             << v.extraInts * (long long)sizeof(int) / 1024 << " KB"
+             << (b == b1 ? "" : "  (WRONG)") << "\n";
+    }
+
+    // --- Merge kernel throughput ---
+    cout << "\n--- Merge Kernel Throughput (two sorted runs of 4M ints) ---\n";
+#ifdef __AVX2__
+    cout << "  (AVX2 enabled)\n";
+#else
+    cout << "  (AVX2 not enabled -- mergeSIMD uses the branchless kernel)\n";
+#endif
+    {
+        const int RUN = 4000000;
+        vector<int> runs = randomArray(2 * RUN, 1 << 30, 7);
+        sort(runs.begin(), runs.begin() + RUN);
+        sort(runs.begin() + RUN, runs.end());
+        vector<int> expected = runs;
+        sort(expected.begin(), expected.end());
+
+        struct Kernel { string name; MergeFn fn; };
+        vector<Kernel> kernels = {
+            {"Scalar merge()      ", merge},
+            {"Branchless merge    ", mergeBranchless},
+            {"SIMD bitonic merge  ", mergeSIMD},
+        };
+        vector<int> aux(2 * RUN);
+        for (auto& kn : kernels) {
+            vector<int> m = runs;
+            auto start = chrono::high_resolution_clock::now();
+            kn.fn(m, aux, 0, RUN - 1, 2 * RUN - 1);
+            auto end = chrono::high_resolution_clock::now();
+            double sec = chrono::duration<double>(end - start).count();
+            double gb = 2.0 * RUN * sizeof(int) / 1e9;  // bytes merged
+            cout << "  " << kn.name << ms(start, end) << " ms, "
+                 << gb / sec << " GB/s" << (m == expected ? "" : "  (WRONG)") << "\n";
+        }
+
+        cout << "  Full sorts with each kernel (n=1,000,000):\n";
+        for (auto& kn : kernels) {
+            vector<int> td = big, bu = big;
+            auto s0 = chrono::high_resolution_clock::now();
+            mergesortTopDown(td, kn.fn);
+            auto s1 = chrono::high_resolution_clock::now();
+            mergesortBottomUp(bu, kn.fn);
+            auto s2 = chrono::high_resolution_clock::now();
+            cout << "    " << kn.name << "top-down " << ms(s0, s1)
+                 << " ms, bottom-up " << ms(s1, s2) << " ms"
+                 << (td == b1 && bu == b1 ? "" : "  (WRONG)") << "\n";
+        }
+    }
+
+    // --- Tuned hybrid sorts ---
+    cout << "\n--- Tuned Hybrid Sorts (thresholds from " << sortTuning.source << ") ---\n";
+    cout << "  insertionCutoff=" << sortTuning.insertionCutoff
+         << " parallelGrain=" << sortTuning.parallelGrain
+         << " radixCrossover=" << sortTuning.radixCrossover << "\n";
+    cout << "  (run with --autotune to measure them on this machine)\n";
+    {
+        struct Tuned { string name; void (*fn)(vector<int>&); };
+        vector<Tuned> tuned = {
+            {"quicksortMedian3 (no cutoff)", [](vector<int>& a) {
+                 quicksortMedian3(a, 0, (int)a.size() - 1); }},
+            {"quicksortTuned              ", quicksortTuned},
+            {"parallelMergesortTuned      ", parallelMergesortTuned},
+            {"radixSortLSD                ", radixSortLSD},
+            {"sortTuned                   ", sortTuned},
+        };
+        for (auto& tn : tuned) {
+            vector<int> b = big;
+            auto start = chrono::high_resolution_clock::now();
+            tn.fn(b);
+            auto end = chrono::high_resolution_clock::now();
+            cout << "  " << tn.name << " " << ms(start, end) << " ms"
+                 << (b == b1 ? "" : "  (WRONG)") << "\n";
+        }
+    }
+
+    // --- String sorts ---
+    cout << "\n--- String Sorts (3-way Quicksort, MSD Radix) ---\n";
+    {
+        vector<string> words = {"she", "sells", "seashells", "by", "the", "sea",
+                                "shore", "the", "shells", "she", "sells", "are",
+                                "surely", "seashells", ""};
+        vector<string> w1 = words, w2 = words;
+        quick3String(w1);
+        msdRadixSort(w2);
+        cout << "  3-way quicksort: ";
+        for (auto& w : w1) cout << "\"" << w << "\" ";
+        cout << "\n  MSD radix sort:  ";
+        for (auto& w : w2) cout << "\"" << w << "\" ";
+        cout << "\n";
+
+        // Keys with long shared prefixes, like URLs or file paths
+        const int NS = 500000;
+        vector<int> ids = randomArray(NS, 100000000, 21);
+        vector<string> keys(NS);
+        for (int i = 0; i < NS; i++)
+            keys[i] = "https://example.com/users/" + to_string(ids[i] % 1000) +
+                      "/items/" + to_string(ids[i]);
+
+        vector<string> k1 = keys, k2 = keys, k3 = keys;
+        auto s0 = chrono::high_resolution_clock::now();
+        sort(k1.begin(), k1.end());
+        auto s1 = chrono::high_resolution_clock::now();
+        quick3String(k2);
+        auto s2 = chrono::high_resolution_clock::now();
+        msdRadixSort(k3);
+        auto s3 = chrono::high_resolution_clock::now();
+
+        string arena;
+        vector<string_view> views = buildArena(keys, arena);
+        auto s4 = chrono::high_resolution_clock::now();
+        msdRadixSort(views);
+        auto s5 = chrono::high_resolution_clock::now();
+        bool viewsOk = true;
+        for (int i = 0; i < NS; i++) viewsOk = viewsOk && views[i] == k1[i];
+
+        cout << "  " << NS << " URL keys:\n";
+        cout << "    std::sort:              " << ms(s0, s1) << " ms\n";
+        cout << "    3-way string quicksort: " << ms(s1, s2) << " ms"
+             << (k2 == k1 ? "" : "  (WRONG)") << "\n";
+        cout << "    MSD radix (string):     " << ms(s2, s3) << " ms"
+             << (k3 == k1 ? "" : "  (WRONG)") << "\n";
+        cout << "    MSD radix (arena view): " << ms(s4, s5) << " ms"
+             << (viewsOk ? "" : "  (WRONG)") << "\n";
+    }
+
     // --- Partition Trace ---
     partitionTrace({15, 3, 9, 8, 5, 2, 7, 1, 6});
 
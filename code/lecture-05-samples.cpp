@@ -7,6 +7,25 @@
 //   2. Max-Heap using array
 //   3. Heapsort algorithm
 //   4. Merging K sorted arrays with a priority queue
+//   5. Cache-aligned d-ary heap template (DaryHeap<T, D, Compare>)
+//   6. Indexed min-priority queue with decreaseKey/increaseKey/remove
+//   7. Bottom-up (Floyd) heapsort, cache-blocked heap construction,
+//      bulk MinHeap construction and batch insert
+//   8. Loser-tree K-way merge over streaming inputs (vectors, files,
+//      generators) with batched output
+//   9. Parallel multiway merge with exact splitters (multi-sequence selection)
+//  10. Relaxed concurrent priority queue (MultiQueue) with rank-error report
+//  11. Radix heap (monotone integer keys) and pairing heap (O(1) insert/meld)
+//  12. Streaming top-K with threshold/SIMD filtering, per-thread merging and
+//      count-min-sketch heavy hitters
+//  13. Hierarchical timing wheel (O(1) schedule/cancel/tick) vs heap timers
+//
+// Compile: g++ -std=c++17 -O2 -pthread [-mavx2] -o lecture-05 lecture-05-samples.cpp
+// Run:     ./lecture-05          (demo, small benchmarks)
+//          ./lecture-05 --bench  (full-size benchmarks)
+//          ./lecture-05 --mq-stress [threads] [ops]
+//                       (MultiQueue conservation check; build with
+//                        -fsanitize=thread to run it under ThreadSanitizer)
 // ============================================================================
 
 #include <iostream>
@@ -14,6 +33,23 @@
 #include <algorithm>
 #include <functional>
 #include <climits>
+#include <string>
+#include <queue>
+#include <new>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <cmath>
+#include <iomanip>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
@@ -56,11 +92,36 @@ class MinHeap {
     }
 
 public:
+    MinHeap() = default;
+
+    // Bulk build: take ownership of the data and heapify bottom-up in O(n)
+    // instead of n swims (O(n log n)).
+    explicit MinHeap(vector<int>&& data) : heap(std::move(data)) {
+        for (int i = (int)heap.size() / 2 - 1; i >= 0; i--) sinkDown(i);
+    }
+
     void insert(int val) {
         heap.push_back(val);
         swimUp(heap.size() - 1);
     }
 
+    // Append k values, then restore heap order only where it can be broken:
+    // the new positions and their ancestors, one level at a time, bottom-up.
+    // Level ranges shrink by half each step, so this is O(k + log^2 n),
+    // never worse than a full O(n + k) heapify (vs O(k log n) for k swims).
+    void insertBatch(const vector<int>& vals) {
+        if (vals.empty()) return;
+        int lo = heap.size();
+        heap.insert(heap.end(), vals.begin(), vals.end());
+        int hi = heap.size() - 1;
+        while (true) {
+            for (int i = hi; i >= lo; i--) sinkDown(i);
+            if (lo == 0) break;
+            lo = (lo - 1) / 2;
+            hi = (hi - 1) / 2;
+        }
+    }
+
     int peek() const {
         return heap.front();
     }
@@ -73,6 +134,14 @@ public:
         return minVal;
     }
 
+    // extractMin followed by insert(val), with a single sinkDown.
+    int replaceMin(int val) {
+        int minVal = heap.front();
+        heap[0] = val;
+        sinkDown(0);
+        return minVal;
+    }
+
     bool empty() const { return heap.empty(); }
     int size() const { return heap.size(); }
 
@@ -139,6 +208,202 @@ public:
     }
 };
 
+// === SECTION: Radix Heap (Monotone Integer Keys) ===
+// When extracted keys never decrease (simulation clocks, Dijkstra
+// distances) and every inserted key is >= the last extracted one, keys can
+// be bucketed by the highest bit in which they differ from 'last':
+//   bucket 0 holds keys == last, bucket b holds keys whose highest
+//   differing bit is b-1.
+// extractMin takes from bucket 0; when it is empty, the first non-empty
+// bucket's minimum becomes the new 'last' and its keys are redistributed
+// into strictly lower buckets. Each key moves down at most 32 times, so
+// operations cost amortized O(log C) with no key comparisons in insert.
+// Same interface as MinHeap; keys must be non-negative.
+
+class RadixHeap {
+    mutable vector<unsigned int> buckets[33];
+    mutable unsigned int last = 0;
+    int count = 0;
+
+    static int bucketOf(unsigned int key, unsigned int last) {
+        return key == last ? 0 : 32 - __builtin_clz(key ^ last);
+    }
+
+    // Ensure bucket 0 is non-empty (requires count > 0).
+    void pull() const {
+        if (!buckets[0].empty()) return;
+        int b = 1;
+        while (buckets[b].empty()) b++;
+        last = *min_element(buckets[b].begin(), buckets[b].end());
+        for (unsigned int key : buckets[b]) buckets[bucketOf(key, last)].push_back(key);
+        buckets[b].clear();
+    }
+
+public:
+    // Precondition: val >= the last extracted key.
+    void insert(int val) {
+        buckets[bucketOf((unsigned int)val, last)].push_back((unsigned int)val);
+        count++;
+    }
+
+    int peek() const {
+        pull();
+        return (int)last;
+    }
+
+    int extractMin() {
+        pull();
+        buckets[0].pop_back();
+        count--;
+        return (int)last;
+    }
+
+    bool empty() const { return count == 0; }
+    int size() const { return count; }
+
+    void printHeap(const string& label) const {
+        cout << label << ": last=" << last;
+        for (int b = 0; b < 33; b++) {
+            if (buckets[b].empty()) continue;
+            cout << " B" << b << "[";
+            for (int i = 0; i < (int)buckets[b].size(); i++)
+                cout << (i ? ", " : "") << buckets[b][i];
+            cout << "]";
+        }
+        cout << endl;
+    }
+};
+
+// === SECTION: Pairing Heap ===
+// A heap-ordered multiway tree stored as child/sibling pointers. insert
+// and meld just link two roots (the larger becomes the first child of the
+// smaller): O(1). extractMin removes the root and combines its children in
+// two passes -- pair them left to right, then fold the pairs right to
+// left -- which gives O(log n) amortized. Same interface as MinHeap, plus
+// meld. Unlike the radix heap, keys need not be monotone.
+
+class PairingHeap {
+    struct PNode {
+        int key;
+        PNode* child;
+        PNode* sibling;
+        PNode(int k) : key(k), child(nullptr), sibling(nullptr) {}
+    };
+    PNode* root = nullptr;
+    int count = 0;
+
+    static PNode* link(PNode* a, PNode* b) {
+        if (a == nullptr) return b;
+        if (b == nullptr) return a;
+        if (b->key < a->key) swap(a, b);
+        b->sibling = a->child;
+        a->child = b;
+        return a;
+    }
+
+    // Two-pass pairing of a sibling list, iterative (no deep recursion).
+    // Pass 1 links pairs left to right and stacks the results through their
+    // sibling pointers; pass 2 pops that stack (right to left) and folds.
+    static PNode* combine(PNode* first) {
+        PNode* stack = nullptr;
+        while (first != nullptr) {
+            PNode* a = first;
+            PNode* b = a->sibling;
+            first = b ? b->sibling : nullptr;
+            a->sibling = nullptr;
+            if (b) b->sibling = nullptr;
+            PNode* pair = link(a, b);
+            pair->sibling = stack;
+            stack = pair;
+        }
+        PNode* result = nullptr;
+        while (stack != nullptr) {
+            PNode* next = stack->sibling;
+            stack->sibling = nullptr;
+            result = link(stack, result);
+            stack = next;
+        }
+        return result;
+    }
+
+    // Extracted nodes are kept on a free list (chained through sibling)
+    // and reused by insert, so steady-state insert/extract never allocates.
+    PNode* freeList = nullptr;
+
+    PNode* newNode(int key) {
+        if (freeList == nullptr) return new PNode(key);
+        PNode* n = freeList;
+        freeList = n->sibling;
+        n->key = key;
+        n->child = n->sibling = nullptr;
+        return n;
+    }
+
+public:
+    PairingHeap() = default;
+    PairingHeap(const PairingHeap&) = delete;
+    PairingHeap& operator=(const PairingHeap&) = delete;
+    ~PairingHeap() {
+        while (freeList != nullptr) {
+            PNode* next = freeList->sibling;
+            delete freeList;
+            freeList = next;
+        }
+        // Free the tree iteratively: children and siblings on an explicit stack
+        vector<PNode*> stack;
+        if (root) stack.push_back(root);
+        while (!stack.empty()) {
+            PNode* n = stack.back();
+            stack.pop_back();
+            if (n->child) stack.push_back(n->child);
+            if (n->sibling) stack.push_back(n->sibling);
+            delete n;
+        }
+    }
+
+    void insert(int val) {
+        root = link(root, newNode(val));
+        count++;
+    }
+
+    // Moves all of other's elements into this heap in O(1).
+    void meld(PairingHeap& other) {
+        root = link(root, other.root);
+        count += other.count;
+        other.root = nullptr;
+        other.count = 0;
+    }
+
+    int peek() const { return root->key; }
+
+    int extractMin() {
+        PNode* old = root;
+        int minVal = old->key;
+        root = combine(old->child);
+        old->sibling = freeList;
+        freeList = old;
+        count--;
+        return minVal;
+    }
+
+    bool empty() const { return root == nullptr; }
+    int size() const { return count; }
+
+    void printHeap(const string& label) const {
+        cout << label << ": ";
+        // Parenthesized tree: key(children...)
+        function<void(PNode*)> show = [&](PNode* n) {
+            for (; n != nullptr; n = n->sibling) {
+                cout << n->key;
+                if (n->child) { cout << "("; show(n->child); cout << ")"; }
+                if (n->sibling) cout << " ";
+            }
+        };
+        show(root);
+        cout << endl;
+    }
+};
+
 // === SECTION: Heapsort ===
 // Heapsort works in two phases:
 //   1. Build a max-heap in-place (bottom-up heap construction)
@@ -178,6 +443,79 @@ void printArray(const vector<int>& arr, const string& label) {
     cout << "]" << endl;
 }
 
+// === SECTION: Bottom-Up Heapsort and Cache-Blocked Heap Construction ===
+// heapSinkDown compares both children with the sinking element: 2 compares
+// per level. In the sort phase the element sunk from the end is almost
+// always small and ends near a leaf anyway, so Floyd's bottom-up sift
+// ("bounce") first walks down the path of larger children to a leaf using
+// 1 compare per level, then climbs back up the few levels needed to place
+// the element. About n lg n compares total instead of 2 n lg n.
+//
+// Building the heap level by level (i = n/2-1 down to 0) sweeps the whole
+// array once per level; for arrays far bigger than cache every sweep goes
+// to memory. The blocked build finishes one subtree at a time instead:
+// subtrees of at most 2^HEAP_BLOCK_LEVELS nodes are built level by level
+// while they are in cache, and the levels above them are built depth-first
+// (left subtree, right subtree, then sift the root). The build uses the
+// ordinary heapSinkDown: during construction a sifted element usually stops
+// within a level or two, so bouncing to a leaf would only add memory traffic.
+
+void heapSinkBottomUp(vector<int>& arr, int i, int n) {
+    int x = arr[i];
+    int hole = i;
+    // Descend along larger children to a leaf, pulling each one up
+    int child;
+    while ((child = 2 * hole + 1) < n) {
+        if (child + 1 < n && arr[child + 1] > arr[child]) child++;
+        arr[hole] = arr[child];
+        hole = child;
+    }
+    // Climb back up until x is no larger than its parent
+    while (hole > i) {
+        int parent = (hole - 1) / 2;
+        if (arr[parent] >= x) break;
+        arr[hole] = arr[parent];
+        hole = parent;
+    }
+    arr[hole] = x;
+}
+
+const int HEAP_BLOCK_LEVELS = 14;  // 16K ints = 64 KB subtrees
+
+void buildHeapSubtree(vector<int>& arr, int root, int n) {
+    if (root >= n / 2) return;  // leaf
+
+    // Height of the subtree (levels along the leftmost path)
+    int height = 0;
+    for (long long j = root; j < n; j = 2 * j + 1) height++;
+
+    if (height <= HEAP_BLOCK_LEVELS) {
+        // Nodes at depth k below root are indices [(root+1)*2^k - 1, +2^k)
+        for (int k = height - 2; k >= 0; k--) {
+            long long lo = ((long long)(root + 1) << k) - 1;
+            long long hi = min(lo + (1LL << k) - 1, (long long)n / 2 - 1);
+            for (long long j = hi; j >= lo; j--) heapSinkDown(arr, (int)j, n);
+        }
+        return;
+    }
+    buildHeapSubtree(arr, 2 * root + 1, n);
+    buildHeapSubtree(arr, 2 * root + 2, n);
+    heapSinkDown(arr, root, n);
+}
+
+void buildHeapBlocked(vector<int>& arr) {
+    buildHeapSubtree(arr, 0, arr.size());
+}
+
+void heapsortBottomUp(vector<int>& arr) {
+    int n = arr.size();
+    buildHeapBlocked(arr);
+    for (int i = n - 1; i > 0; i--) {
+        swap(arr[0], arr[i]);
+        heapSinkBottomUp(arr, 0, i);
+    }
+}
+
 // === SECTION: Merge K Sorted Arrays ===
 // Use a min-heap to efficiently merge K sorted arrays.
 // We push one element from each array, then repeatedly extract the min
@@ -243,9 +581,907 @@ vector<int> mergeKSortedArrays(const vector<vector<int>>& arrays) {
     return result;
 }
 
+// === SECTION: Loser-Tree K-Way Merge over Streams ===
+// mergeKSortedArrays above needs every input in memory and its heap pop
+// does ~2 lg K compares (two children per level on the way down).
+//
+// A tournament "loser tree" keeps the K current heads as leaves of a
+// complete binary tree. Each internal node remembers the *loser* of the
+// match played there, and tree[0] holds the overall winner. After the
+// winner's stream advances, only the matches on its leaf-to-root path are
+// replayed, each against the stored loser: exactly ceil(lg K) compares.
+//
+// Inputs are abstract sorted streams, so they can be in-memory ranges,
+// buffered files or generators. Output goes to a sink in fixed-size
+// batches. Memory is O(K) for the tree plus each stream's own buffer,
+// independent of the total number of elements.
+
+class SortedStream {
+public:
+    virtual ~SortedStream() = default;
+    // Stores the next value in out; returns false when the stream is done.
+    virtual bool next(int& out) = 0;
+};
+
+// Any iterator range (vector, deque, array, ...).
+template <typename It>
+class IteratorStream : public SortedStream {
+    It cur, end;
+public:
+    IteratorStream(It b, It e) : cur(b), end(e) {}
+    bool next(int& out) override {
+        if (cur == end) return false;
+        out = *cur++;
+        return true;
+    }
+};
+
+// Binary file of native ints, read through a fixed-size buffer.
+class FileStream : public SortedStream {
+    FILE* file;
+    vector<int> buf;
+    size_t pos = 0, len = 0;
+public:
+    FileStream(const string& path, size_t bufInts = 1024)
+        : file(fopen(path.c_str(), "rb")), buf(bufInts) {}
+    ~FileStream() { if (file) fclose(file); }
+    FileStream(const FileStream&) = delete;
+    FileStream& operator=(const FileStream&) = delete;
+
+    bool ok() const { return file != nullptr; }
+
+    bool next(int& out) override {
+        if (pos == len) {
+            if (!file) return false;
+            len = fread(buf.data(), sizeof(int), buf.size(), file);
+            pos = 0;
+            if (len == 0) return false;
+        }
+        out = buf[pos++];
+        return true;
+    }
+};
+
+// Wraps a callable bool(int&), e.g. a generator of sorted values.
+class GeneratorStream : public SortedStream {
+    function<bool(int&)> gen;
+public:
+    explicit GeneratorStream(function<bool(int&)> g) : gen(std::move(g)) {}
+    bool next(int& out) override { return gen(out); }
+};
+
+class LoserTree {
+    // Each entry packs (key, stream) into one 64-bit value: the key with its
+    // sign bit flipped in the high half, the stream index in the low half.
+    // One unsigned compare then orders by key and breaks ties by stream
+    // index (a stable merge), and an exhausted stream is simply DONE, which
+    // loses to everything.
+    static constexpr uint64_t DONE = UINT64_MAX;
+    vector<SortedStream*> in;
+    vector<uint64_t> tree;  // tree[0] = winner, tree[1..k-1] = losers
+    int k;
+
+    uint64_t head(int s) {
+        int val;
+        if (!in[s]->next(val)) return DONE;
+        return ((uint64_t)((uint32_t)val ^ 0x80000000u) << 32) | (uint32_t)s;
+    }
+
+    // Internal nodes 1..k-1 have children 2i and 2i+1; node k+s is leaf s.
+    uint64_t build(int node, const vector<uint64_t>& leaf) {
+        if (node >= k) return leaf[node - k];
+        uint64_t l = build(2 * node, leaf), r = build(2 * node + 1, leaf);
+        tree[node] = max(l, r);  // loser stays here
+        return min(l, r);        // winner moves up
+    }
+
+public:
+    explicit LoserTree(const vector<SortedStream*>& inputs)
+        : in(inputs), tree(max<size_t>(inputs.size(), 1), DONE), k(inputs.size()) {
+        vector<uint64_t> leaf(k);
+        for (int s = 0; s < k; s++) leaf[s] = head(s);
+        if (k > 0) tree[0] = build(1, leaf);
+    }
+
+    bool empty() const { return tree[0] == DONE; }
+
+    // Returns the smallest head, advances its stream and replays the
+    // ceil(lg K) matches on that stream's path.
+    int pop() {
+        uint64_t w = tree[0];
+        int s = (int)(uint32_t)w;
+        int val = (int)((uint32_t)(w >> 32) ^ 0x80000000u);
+        uint64_t winner = head(s);
+        for (int node = (s + k) / 2; node >= 1; node /= 2)
+            if (tree[node] < winner) swap(tree[node], winner);
+        tree[0] = winner;
+        return val;
+    }
+};
+
+typedef function<void(const int*, size_t)> BatchSink;
+
+// Merges all inputs, passing output to sink in batches of batchSize.
+// Returns the number of elements merged.
+long long mergeStreams(const vector<SortedStream*>& inputs, const BatchSink& sink,
+                       size_t batchSize = 4096) {
+    LoserTree lt(inputs);
+    vector<int> batch(batchSize);
+    size_t n = 0;
+    long long total = 0;
+    while (!lt.empty()) {
+        batch[n++] = lt.pop();
+        if (n == batchSize) { sink(batch.data(), n); total += n; n = 0; }
+    }
+    if (n > 0) { sink(batch.data(), n); total += n; }
+    return total;
+}
+
+// === SECTION: Parallel Multiway Merge with Splitter Co-Ranking ===
+// To merge K sorted arrays on P threads, cut the *output* into P equal
+// ranges and find, for every cut rank r, the position in each input where
+// the first r output elements end (co-ranking). Each thread then merges
+// its K slices into its own range of a preallocated output buffer with
+// no synchronization.
+//
+// Multi-sequence selection for rank r: binary-search the value v of the
+// r-th smallest element (count(<= v) over all inputs via K binary
+// searches), take every element < v, then take the remaining r - count(< v)
+// copies of v from the inputs in index order. The cuts are exact even with
+// duplicates, and cost O(32 K log n) each.
+
+// positions[i] = how many elements of arrays[i] belong to the first r outputs
+vector<size_t> coRank(const vector<vector<int>>& arrays, size_t r) {
+    int K = arrays.size();
+    vector<size_t> pos(K);
+    size_t total = 0;
+    for (auto& a : arrays) total += a.size();
+    if (r >= total) {
+        for (int i = 0; i < K; i++) pos[i] = arrays[i].size();
+        return pos;
+    }
+
+    // Smallest v with count(<= v) > r, i.e. the value of the r-th element
+    long long lo = INT_MIN, hi = INT_MAX;
+    while (lo < hi) {
+        long long mid = lo + (hi - lo) / 2;
+        size_t countLE = 0;
+        for (auto& a : arrays)
+            countLE += upper_bound(a.begin(), a.end(), (int)mid) - a.begin();
+        if (countLE > r) hi = mid;
+        else             lo = mid + 1;
+    }
+    int v = (int)lo;
+
+    size_t taken = 0;
+    for (int i = 0; i < K; i++) {
+        pos[i] = lower_bound(arrays[i].begin(), arrays[i].end(), v) - arrays[i].begin();
+        taken += pos[i];
+    }
+    size_t need = r - taken;  // copies of v still to assign, lowest index first
+    for (int i = 0; i < K && need > 0; i++) {
+        size_t equal = (upper_bound(arrays[i].begin(), arrays[i].end(), v) - arrays[i].begin()) - pos[i];
+        size_t t = min(need, equal);
+        pos[i] += t;
+        need -= t;
+    }
+    return pos;
+}
+
+// Merges arrays into out (sized to the total) using the given number of
+// threads (0 = hardware concurrency).
+void parallelMultiwayMerge(const vector<vector<int>>& arrays, vector<int>& out,
+                           int numThreads = 0) {
+    if (numThreads <= 0) numThreads = max(1u, thread::hardware_concurrency());
+    size_t total = 0;
+    for (auto& a : arrays) total += a.size();
+    out.resize(total);
+
+    // Cut ranks 0 = r_0 < r_1 < ... < r_P = total
+    vector<vector<size_t>> cuts(numThreads + 1);
+    for (int t = 0; t <= numThreads; t++)
+        cuts[t] = coRank(arrays, total * t / numThreads);
+
+    auto mergeRange = [&](int t) {
+        vector<unique_ptr<SortedStream>> slices;
+        vector<SortedStream*> streams;
+        for (int i = 0; i < (int)arrays.size(); i++) {
+            auto base = arrays[i].begin();
+            if (cuts[t][i] == cuts[t + 1][i]) continue;
+            slices.emplace_back(new IteratorStream<vector<int>::const_iterator>(
+                base + cuts[t][i], base + cuts[t + 1][i]));
+            streams.push_back(slices.back().get());
+        }
+        int* dst = out.data() + total * t / numThreads;
+        mergeStreams(streams, [&dst](const int* p, size_t n) {
+            copy(p, p + n, dst);
+            dst += n;
+        });
+    };
+
+    vector<thread> workers;
+    for (int t = 1; t < numThreads; t++) workers.emplace_back(mergeRange, t);
+    mergeRange(0);
+    for (auto& w : workers) w.join();
+}
+
+// === SECTION: Cache-Aligned D-ary Heap ===
+// MinHeap/MaxHeap above are binary, so sinkDown moves one level per compare
+// pair and every level is a new cache line. A d-ary heap has D children per
+// node: the tree is log_D(n) levels deep, and each level scans D children.
+//
+// If the D children of a node sit in one cache line, each level costs one
+// cache miss. Children of logical node i are D*i+1 .. D*i+D. Storing node i
+// at slot i + (D-1) moves the first child to slot D*(i+1), a multiple of D.
+// With 64-byte aligned storage and D*sizeof(T) <= 64, every child group
+// starts on a group boundary and never straddles two cache lines.
+//
+// Compare(a, b) is true when a should come out before b, so the default
+// less<T> gives a min-heap and greater<T> a max-heap. T must be default-
+// constructible (for the D-1 padding slots) and movable.
+
+const size_t CACHE_LINE = 64;
+
+// Minimal allocator that returns 64-byte aligned blocks.
+template <typename T>
+struct CacheAlignedAllocator {
+    typedef T value_type;
+    CacheAlignedAllocator() = default;
+    template <typename U> CacheAlignedAllocator(const CacheAlignedAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), align_val_t(CACHE_LINE)));
+    }
+    void deallocate(T* p, size_t) { ::operator delete(p, align_val_t(CACHE_LINE)); }
+
+    template <typename U> bool operator==(const CacheAlignedAllocator<U>&) const { return true; }
+    template <typename U> bool operator!=(const CacheAlignedAllocator<U>&) const { return false; }
+};
+
+template <typename T, int D = 4, typename Compare = less<T>>
+class DaryHeap {
+    static_assert(D == 2 || D == 4 || D == 8, "D must be 2, 4 or 8");
+
+    static const int PAD = D - 1;  // slots before the root
+    vector<T, CacheAlignedAllocator<T>> slots;
+    Compare cmp;
+
+    T& at(size_t i) { return slots[i + PAD]; }
+
+    // Hole-based sift: move the value out once, shift parents/children into
+    // the hole, and move the value into its final slot (one move per level
+    // instead of a three-move swap).
+    void swimUp(size_t i) {
+        T val = std::move(at(i));
+        while (i > 0) {
+            size_t parent = (i - 1) / D;
+            if (!cmp(val, at(parent))) break;
+            at(i) = std::move(at(parent));
+            i = parent;
+        }
+        at(i) = std::move(val);
+    }
+
+    void sinkDown(size_t i) {
+        size_t n = size();
+        T val = std::move(at(i));
+        while (true) {
+            size_t first = D * i + 1;
+            if (first >= n) break;
+            size_t last = min(first + D, n);
+            size_t best = first;
+            for (size_t c = first + 1; c < last; c++)
+                if (cmp(at(c), at(best))) best = c;
+            if (!cmp(at(best), val)) break;
+            at(i) = std::move(at(best));
+            i = best;
+        }
+        at(i) = std::move(val);
+    }
+
+public:
+    explicit DaryHeap(Compare c = Compare()) : slots(PAD), cmp(c) {}
+
+    void reserve(size_t n) { slots.reserve(n + PAD); }
+
+    void insert(const T& val) { slots.push_back(val); swimUp(size() - 1); }
+    void insert(T&& val) { slots.push_back(std::move(val)); swimUp(size() - 1); }
+
+    template <typename... Args>
+    void emplace(Args&&... args) {
+        slots.emplace_back(std::forward<Args>(args)...);
+        swimUp(size() - 1);
+    }
+
+    const T& peek() const { return slots[PAD]; }
+
+    // Removes and returns the top element (moved out, not copied).
+    T extract() {
+        T top = std::move(at(0));
+        if (size() > 1) {
+            at(0) = std::move(slots.back());
+            slots.pop_back();
+            sinkDown(0);
+        } else {
+            slots.pop_back();
+        }
+        return top;
+    }
+
+    bool empty() const { return slots.size() == (size_t)PAD; }
+    size_t size() const { return slots.size() - PAD; }
+};
+
+// === SECTION: Indexed Min-Priority Queue ===
+// Each entry is identified by an integer handle in [0, maxN), e.g. a graph
+// vertex. Two arrays map between handles and heap positions:
+//   pq[pos]    = handle stored at heap position pos
+//   qp[handle] = heap position of handle, or -1 if not in the queue
+// so a handle can be found in O(1) and its key changed in place with one
+// swim or sink. Dijkstra/Prim can then keep at most V entries instead of
+// pushing a duplicate per relaxation (O(E) entries).
+
+template <typename Key>
+class IndexMinPQ {
+    vector<int> pq;     // heap of handles
+    vector<int> qp;     // inverse of pq
+    vector<Key> keys;   // keys[handle]
+
+    bool greaterAt(int a, int b) const { return keys[pq[a]] > keys[pq[b]]; }
+
+    void exch(int a, int b) {
+        swap(pq[a], pq[b]);
+        qp[pq[a]] = a;
+        qp[pq[b]] = b;
+    }
+
+    void swimUp(int i) {
+        while (i > 0) {
+            int parent = (i - 1) / 2;
+            if (!greaterAt(parent, i)) break;
+            exch(i, parent);
+            i = parent;
+        }
+    }
+
+    void sinkDown(int i) {
+        int n = pq.size();
+        while (2 * i + 1 < n) {
+            int child = 2 * i + 1;
+            if (child + 1 < n && greaterAt(child, child + 1)) child++;
+            if (!greaterAt(i, child)) break;
+            exch(i, child);
+            i = child;
+        }
+    }
+
+public:
+    explicit IndexMinPQ(int maxN) : qp(maxN, -1), keys(maxN) { pq.reserve(maxN); }
+
+    bool contains(int handle) const { return qp[handle] != -1; }
+    bool empty() const { return pq.empty(); }
+    int size() const { return pq.size(); }
+
+    // Precondition: handle is not already in the queue.
+    void insert(int handle, const Key& key) {
+        keys[handle] = key;
+        qp[handle] = pq.size();
+        pq.push_back(handle);
+        swimUp(pq.size() - 1);
+    }
+
+    int minIndex() const { return pq.front(); }
+    const Key& minKey() const { return keys[pq.front()]; }
+    const Key& keyOf(int handle) const { return keys[handle]; }
+
+    // Removes the minimum entry and returns its handle.
+    int extractMin() {
+        int top = pq.front();
+        remove(top);
+        return top;
+    }
+
+    // Precondition: handle is in the queue and key <= its current key.
+    void decreaseKey(int handle, const Key& key) {
+        keys[handle] = key;
+        swimUp(qp[handle]);
+    }
+
+    // Precondition: handle is in the queue and key >= its current key.
+    void increaseKey(int handle, const Key& key) {
+        keys[handle] = key;
+        sinkDown(qp[handle]);
+    }
+
+    // Either direction.
+    void changeKey(int handle, const Key& key) {
+        if (key < keys[handle]) decreaseKey(handle, key);
+        else                    increaseKey(handle, key);
+    }
+
+    // Removes handle from the queue in O(log n). Precondition: contains(handle).
+    void remove(int handle) {
+        int i = qp[handle];
+        int last = pq.size() - 1;
+        if (i != last) {
+            exch(i, last);
+            pq.pop_back();
+            int moved = pq[i];  // former last entry may need to go either way
+            swimUp(i);
+            sinkDown(qp[moved]);
+        } else {
+            pq.pop_back();
+        }
+        qp[handle] = -1;
+    }
+};
+
+// === SECTION: Streaming Top-K Aggregator ===
+// Keep the K largest items seen so far in a MinHeap of size K. Its minimum
+// is the admission threshold: anything not larger is rejected with one
+// compare (the common case once the stream is warm), anything larger
+// replaces the minimum with one sinkDown. Memory is O(K) for any stream.
+//
+// For the K *smallest* items the keys are stored as ~x (= -x-1), which
+// reverses the order without overflow, so the same min-heap works.
+//
+// offerBatch filters a block with AVX2 when available: 8 keys are compared
+// with the threshold at once and the block is skipped if none pass.
+// ConcurrentTopK gives each thread its own StreamingTopK (no sharing on
+// the hot path) and merges them when a result is requested.
+
+class StreamingTopK {
+    MinHeap heap;
+    int k;
+    bool largest;
+    long long seen = 0, rejected = 0;
+
+    int encode(int x) const { return largest ? x : ~x; }
+
+public:
+    explicit StreamingTopK(int k, bool largest = true) : k(k), largest(largest) {}
+
+    void offer(int x) {
+        seen++;
+        int e = encode(x);
+        if (heap.size() < k)        heap.insert(e);
+        else if (e > heap.peek())   heap.replaceMin(e);
+        else                        rejected++;  // fast-path reject
+    }
+
+    void offerBatch(const int* data, size_t n) {
+        size_t i = 0;
+        while (i < n && heap.size() < k) offer(data[i++]);
+#ifdef __AVX2__
+        const __m256i flip = _mm256_set1_epi32(largest ? 0 : -1);  // ~x == x ^ -1
+        for (; i + 8 <= n; i += 8) {
+            __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(data + i)), flip);
+            __m256i thr = _mm256_set1_epi32(heap.peek());
+            int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, thr)));
+            if (mask == 0) { seen += 8; rejected += 8; continue; }
+            for (int lane = 0; lane < 8; lane++) offer(data[i + lane]);
+        }
+#endif
+        for (; i < n; i++) offer(data[i]);
+    }
+
+    // Folds another aggregator's current top-K into this one.
+    void merge(const StreamingTopK& other) {
+        for (int x : other.result()) offer(x);
+    }
+
+    // Current top-K, best first (largest first, or smallest first).
+    vector<int> result() const {
+        MinHeap copy = heap;
+        vector<int> out;
+        while (!copy.empty()) out.push_back(largest ? copy.extractMin() : ~copy.extractMin());
+        reverse(out.begin(), out.end());
+        return out;
+    }
+
+    int threshold() const { return largest ? heap.peek() : ~heap.peek(); }
+    double rejectRate() const { return seen ? (double)rejected / seen : 0; }
+};
+
+class ConcurrentTopK {
+    struct Local {
+        mutex lock;          // uncontended except while merging
+        StreamingTopK topK;
+        Local(int k, bool largest) : topK(k, largest) {}
+    };
+    int k;
+    bool largest;
+    long long id;
+    mutex registryLock;
+    vector<unique_ptr<Local>> locals;
+
+    static long long nextId() {
+        static atomic<long long> counter{0};
+        return counter++;
+    }
+
+    Local& local() {
+        thread_local unordered_map<long long, Local*> mine;  // aggregator id -> slot
+        Local*& slot = mine[id];
+        if (slot == nullptr) {
+            lock_guard<mutex> guard(registryLock);
+            locals.emplace_back(new Local(k, largest));
+            slot = locals.back().get();
+        }
+        return *slot;
+    }
+
+public:
+    ConcurrentTopK(int k, bool largest = true) : k(k), largest(largest), id(nextId()) {}
+
+    void offerBatch(const int* data, size_t n) {
+        Local& l = local();
+        lock_guard<mutex> guard(l.lock);
+        l.topK.offerBatch(data, n);
+    }
+
+    // Merge of all per-thread aggregators, best first.
+    vector<int> result() {
+        StreamingTopK merged(k, largest);
+        lock_guard<mutex> guard(registryLock);
+        for (auto& l : locals) {
+            lock_guard<mutex> lg(l->lock);
+            merged.merge(l->topK);
+        }
+        return merged.result();
+    }
+};
+
+// === SECTION: Heavy Hitters with a Count-Min Sketch ===
+// A count-min sketch estimates item frequencies in fixed memory: d rows of
+// w counters, each row with its own hash. An update adds to one counter
+// per row; the estimate is the minimum over rows (never an underestimate,
+// over by at most e*N/w with probability 1 - e^-d).
+//
+// HeavyHitters keeps the K items with the largest estimated counts. Counts
+// grow while an item is tracked, so instead of MinHeap it uses IndexMinPQ
+// (slots 0..K-1 as handles) to raise a key in place; the tracked minimum
+// is the admission threshold, as in StreamingTopK.
+
+class CountMinSketch {
+    int width, depth;
+    vector<unsigned int> counts;   // depth rows of width counters
+    vector<unsigned long long> seeds;
+
+    size_t cell(int row, int key) const {
+        unsigned long long h = (unsigned long long)(unsigned int)key * seeds[row];
+        h ^= h >> 29;
+        return (size_t)row * width + (size_t)(h % width);
+    }
+
+public:
+    CountMinSketch(int width, int depth) : width(width), depth(depth),
+        counts((size_t)width * depth, 0) {
+        unsigned long long s = 0x9E3779B97F4A7C15ULL;
+        for (int r = 0; r < depth; r++) { s = s * 6364136223846793005ULL + 1442695040888963407ULL; seeds.push_back(s | 1); }
+    }
+
+    // Adds one occurrence and returns the new estimate.
+    unsigned int update(int key) {
+        unsigned int est = UINT_MAX;
+        for (int r = 0; r < depth; r++) est = min(est, ++counts[cell(r, key)]);
+        return est;
+    }
+
+    unsigned int estimate(int key) const {
+        unsigned int est = UINT_MAX;
+        for (int r = 0; r < depth; r++) est = min(est, counts[cell(r, key)]);
+        return est;
+    }
+};
+
+class HeavyHitters {
+    CountMinSketch sketch;
+    IndexMinPQ<long long> tracked;     // slot -> estimated count
+    vector<int> slotKey;               // slot -> item
+    unordered_map<int, int> slotOf;    // item -> slot
+    int k;
+
+public:
+    HeavyHitters(int k, int width = 1 << 16, int depth = 4)
+        : sketch(width, depth), tracked(k), k(k) {}
+
+    void offer(int key) {
+        long long est = sketch.update(key);
+        auto it = slotOf.find(key);
+        if (it != slotOf.end()) {
+            tracked.increaseKey(it->second, est);
+        } else if ((int)slotKey.size() < k) {
+            int slot = slotKey.size();
+            slotKey.push_back(key);
+            slotOf[key] = slot;
+            tracked.insert(slot, est);
+        } else if (est > tracked.minKey()) {   // beats the weakest tracked item
+            int slot = tracked.extractMin();
+            slotOf.erase(slotKey[slot]);
+            slotKey[slot] = key;
+            slotOf[key] = slot;
+            tracked.insert(slot, est);
+        }
+    }
+
+    // (item, estimated count), most frequent first.
+    vector<pair<int, long long>> result() const {
+        vector<pair<int, long long>> out;
+        for (auto& [key, slot] : slotOf) out.push_back({key, tracked.keyOf(slot)});
+        sort(out.begin(), out.end(), [](auto& a, auto& b) { return a.second > b.second; });
+        return out;
+    }
+};
+
+// === SECTION: Relaxed Concurrent Priority Queue (MultiQueue) ===
+// One heap behind one mutex serializes every thread. A MultiQueue uses
+// c * threads independent heaps, each with its own lock:
+//   insert:     lock a random heap (try_lock; on failure pick another).
+//   extractMin: pick two random heaps, peek both tops without locking
+//               (each heap publishes its top in an atomic), and pop from
+//               the one with the smaller top ("power of two choices").
+// The result is not always the global minimum, but the expected rank of
+// the removed element is O(number of heaps), and threads rarely contend.
+// Keys are ints; INT_MAX is reserved to mean "empty".
+
+class MultiQueue {
+    // Each queue starts on its own cache line, so two queues never share
+    // one. The lock and the published top (what other threads touch) fill
+    // the first line; the heap's vector header spills into the second.
+    struct alignas(64) Queue {
+        mutex lock;
+        atomic<int> top{INT_MAX};        // heap.peek(), or INT_MAX if empty
+        DaryHeap<int, 4> heap;
+    };
+    unique_ptr<Queue[]> queues;
+    int numQueues;
+
+    static unsigned int randomIndex(unsigned int bound) {
+        // xorshift32, one state per thread
+        static thread_local unsigned int state =
+            (unsigned int)hash<thread::id>()(this_thread::get_id()) | 1u;
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state % bound;
+    }
+
+    void publishTop(Queue& q) {
+        q.top.store(q.heap.empty() ? INT_MAX : q.heap.peek(), memory_order_relaxed);
+    }
+
+public:
+    explicit MultiQueue(int threads, int c = 2)
+        : queues(new Queue[max(2, c * threads)]), numQueues(max(2, c * threads)) {}
+
+    int queueCount() const { return numQueues; }
+
+    void insert(int key) {
+        while (true) {
+            Queue& q = queues[randomIndex(numQueues)];
+            if (!q.lock.try_lock()) continue;
+            q.heap.insert(key);
+            publishTop(q);
+            q.lock.unlock();
+            return;
+        }
+    }
+
+    // Removes an element close to the minimum. Returns false only if every
+    // heap was seen empty.
+    bool extractMin(int& out) {
+        for (int attempt = 0; attempt < 4 * numQueues; attempt++) {
+            int a = randomIndex(numQueues), b = randomIndex(numQueues);
+            int ta = queues[a].top.load(memory_order_relaxed);
+            int tb = queues[b].top.load(memory_order_relaxed);
+            Queue& q = queues[tb < ta ? b : a];
+            if (min(ta, tb) == INT_MAX) continue;     // both look empty
+            if (!q.lock.try_lock()) continue;
+            bool got = !q.heap.empty();               // top may be stale
+            if (got) { out = q.heap.extract(); publishTop(q); }
+            q.lock.unlock();
+            if (got) return true;
+        }
+        // Random probes kept missing: scan every heap before giving up
+        for (int i = 0; i < numQueues; i++) {
+            lock_guard<mutex> guard(queues[i].lock);
+            if (!queues[i].heap.empty()) {
+                out = queues[i].heap.extract();
+                publishTop(queues[i]);
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// Conservation check: each thread inserts its own keys and extracts as many
+// elements as it inserted, then the queue is drained. Every key must come
+// out exactly once. Build with -fsanitize=thread to run it under
+// ThreadSanitizer. Returns 0 on success.
+int runMultiQueueStress(int threads, int opsPerThread) {
+    cout << "--- MultiQueue stress (" << threads << " threads x " << opsPerThread
+         << " insert+extract) ---" << endl;
+    // key = random * total + id keeps keys unique and below INT_MAX
+    int total = threads * opsPerThread;
+    int spread = max(1, INT_MAX / total - 1);
+    MultiQueue mq(threads);
+    vector<vector<int>> extracted(threads);
+    vector<thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&, t] {
+            unsigned int s = 2654435761u * (t + 1);
+            for (int i = 0; i < opsPerThread; i++) {
+                s = s * 1103515245u + 12345u;
+                mq.insert((int)((s >> 8) % spread) * total + t * opsPerThread + i);
+                int out;
+                if (mq.extractMin(out)) extracted[t].push_back(out);
+            }
+        });
+    }
+    for (auto& t : pool) t.join();
+
+    vector<int> all;
+    for (auto& v : extracted) all.insert(all.end(), v.begin(), v.end());
+    int out;
+    while (mq.extractMin(out)) all.push_back(out);
+    // The ids (key mod total) must be exactly 0..total-1
+    vector<int> ids;
+    for (int k : all) ids.push_back(k % total);
+    sort(ids.begin(), ids.end());
+    bool ok = (int)ids.size() == total;
+    for (int i = 0; ok && i < total; i++) ok = ids[i] == i;
+    cout << "  " << total << " keys inserted, " << all.size() << " extracted: "
+         << (ok ? "OK" : "FAILED") << endl;
+    return ok ? 0 : 1;
+}
+
+// === SECTION: Hierarchical Timing Wheel ===
+// A heap timer queue pays O(log n) to schedule and to cancel, even though
+// most timeouts are cancelled long before they fire. A timing wheel is a
+// ring of slots, one per tick; a timer is linked into the slot of its
+// expiry tick and the wheel fires one slot per tick. Schedule, cancel and
+// tick are O(1).
+//
+// Hierarchy: with LEVELS wheels of 2^BITS slots, level l has slots of
+// 2^(BITS*l) ticks. Writing expiry times as base-2^BITS digits, a timer
+// goes to the lowest level l at which its higher digits match the current
+// time, in the slot given by its level-l digit. When the current time
+// enters a new level-l slot (all lower digits roll over to 0), that slot's
+// timers "cascade" down to finer levels. Timers beyond the top level wait
+// in an overflow list that is re-examined whenever the top level wraps.
+// Each timer cascades at most LEVELS times.
+//
+// Timers live in a pool and are linked into slots by index (doubly linked
+// lists), so cancel is an O(1) unlink. Handles carry a generation count so
+// cancelling a timer that already fired or was cancelled is a no-op.
+
+class TimingWheel {
+    struct Timer {
+        long long expires;   // in ticks
+        int prev, next;      // list links (pool indices, -1 = none)
+        int list;            // list this timer is on, -1 if free
+        unsigned int gen;
+        int payload;
+    };
+
+    int bits, levels;
+    long long mask;
+    long long resolution;          // time units per tick
+    long long now = 0;             // current tick
+    vector<Timer> pool;
+    vector<int> freeTimers;
+    vector<int> heads;             // levels * 2^bits slot lists + 1 overflow list
+    int overflowList;
+    int active = 0;
+
+    void pushFront(int list, int t) {
+        Timer& tm = pool[t];
+        tm.list = list;
+        tm.prev = -1;
+        tm.next = heads[list];
+        if (tm.next != -1) pool[tm.next].prev = t;
+        heads[list] = t;
+    }
+
+    void unlink(int t) {
+        Timer& tm = pool[t];
+        if (tm.prev != -1) pool[tm.prev].next = tm.next;
+        else               heads[tm.list] = tm.next;
+        if (tm.next != -1) pool[tm.next].prev = tm.prev;
+        tm.list = -1;
+    }
+
+    // Lowest level whose higher digits agree with now; overflow if none.
+    void place(int t) {
+        long long exp = pool[t].expires;
+        for (int l = 0; l < levels; l++) {
+            int shift = bits * (l + 1);
+            if ((exp >> shift) == (now >> shift)) {
+                pushFront(l * (1 << bits) + (int)((exp >> (bits * l)) & mask), t);
+                return;
+            }
+        }
+        pushFront(overflowList, t);
+    }
+
+    // Detach a whole list and re-place its timers relative to now.
+    void cascade(int list) {
+        int t = heads[list];
+        heads[list] = -1;
+        while (t != -1) {
+            int next = pool[t].next;
+            place(t);
+            t = next;
+        }
+    }
+
+public:
+    // resolution: time units per tick; 2^(bits*levels) ticks before overflow.
+    explicit TimingWheel(long long resolution = 1, int bits = 8, int levels = 4)
+        : bits(bits), levels(levels), mask((1LL << bits) - 1), resolution(resolution),
+          heads(levels * (1 << bits) + 1, -1), overflowList(levels * (1 << bits)) {}
+
+    // Schedules payload to fire after delay time units (rounded up to whole
+    // ticks, at least one). Returns a handle for cancel.
+    long long schedule(long long delay, int payload) {
+        long long ticks = max(1LL, (delay + resolution - 1) / resolution);
+        int t;
+        if (!freeTimers.empty()) { t = freeTimers.back(); freeTimers.pop_back(); }
+        else { t = pool.size(); pool.push_back({0, -1, -1, -1, 0, 0}); }
+        pool[t].expires = now + ticks;
+        pool[t].payload = payload;
+        place(t);
+        active++;
+        return ((long long)pool[t].gen << 32) | t;
+    }
+
+    // Returns true if the timer was pending and is now cancelled.
+    bool cancel(long long handle) {
+        int t = (int)(handle & 0xFFFFFFFF);
+        unsigned int gen = (unsigned int)(handle >> 32);
+        if (t >= (int)pool.size() || pool[t].gen != gen || pool[t].list == -1) return false;
+        unlink(t);
+        pool[t].gen++;
+        freeTimers.push_back(t);
+        active--;
+        return true;
+    }
+
+    // Advances one tick and calls onExpire(payload) for each timer due.
+    // onExpire may schedule or cancel timers.
+    template <typename Fn>
+    void tick(Fn&& onExpire) {
+        now++;
+        long long below = now & ((1LL << (bits * levels)) - 1);
+        if (below == 0) cascade(overflowList);
+        for (int l = levels - 1; l >= 1; l--) {
+            if ((now & ((1LL << (bits * l)) - 1)) == 0)
+                cascade(l * (1 << bits) + (int)((now >> (bits * l)) & mask));
+        }
+        int slot = (int)(now & mask);
+        while (heads[slot] != -1) {
+            int t = heads[slot];
+            unlink(t);
+            pool[t].gen++;
+            freeTimers.push_back(t);
+            active--;
+            onExpire(pool[t].payload);
+        }
+    }
+
+    long long currentTime() const { return now * resolution; }
+    int pending() const { return active; }
+};
+
 // === MAIN ===
 
-int main() {
+int main(int argc, char** argv) {
+    bool fullBench = argc > 1 && string(argv[1]) == "--bench";
+    if (argc > 1 && string(argv[1]) == "--mq-stress")
+        return runMultiQueueStress(argc > 2 ? atoi(argv[2]) : 4, argc > 3 ? atoi(argv[3]) : 100000);
+
     cout << "========================================" << endl;
     cout << " Lecture 05: Priority Queues & Heapsort" << endl;
     cout << "========================================" << endl;
@@ -294,5 +1530,687 @@ int main() {
     vector<int> merged = mergeKSortedArrays(sortedArrays);
     printArray(merged, "  Merged");
 
+    // --- Demo 5: D-ary heap ---
+    cout << "\n--- D-ary Heap Demo ---" << endl;
+    DaryHeap<int, 4> dMin;
+    DaryHeap<int, 8, greater<int>> dMax;
+    for (int v : vals) { dMin.insert(v); dMax.insert(v); }
+    cout << "  4-ary min extract sequence: ";
+    while (!dMin.empty()) cout << dMin.extract() << " ";
+    cout << endl << "  8-ary max extract sequence: ";
+    while (!dMax.empty()) cout << dMax.extract() << " ";
+    cout << endl;
+
+    DaryHeap<pair<int, string>, 4> jobs;  // payloads are moved, not copied
+    jobs.emplace(3, "compress");
+    jobs.emplace(1, "parse");
+    jobs.emplace(2, "index");
+    cout << "  Jobs by priority: ";
+    while (!jobs.empty()) cout << jobs.extract().second << " ";
+    cout << endl;
+
+    // --- Demo 6: Heap benchmark ---
+    // N inserts, then N extract+insert pairs, then N extracts.
+    const int BENCH_N = fullBench ? 10000000 : 200000;
+    cout << "\n--- Heap Benchmark (" << BENCH_N << " inserts, "
+         << BENCH_N << " extract+insert, " << BENCH_N << " extracts) ---" << endl;
+    vector<int> keys(2 * BENCH_N);
+    unsigned int seed = 42;
+    for (int& k : keys) {
+        seed = seed * 1103515245u + 12345u;
+        k = (int)(seed >> 1);
+    }
+    auto runBench = [&](const string& name, auto& heap, auto push, auto pop) {
+        auto start = chrono::high_resolution_clock::now();
+        long long checksum = 0;
+        for (int i = 0; i < BENCH_N; i++) push(heap, keys[i]);
+        for (int i = 0; i < BENCH_N; i++) {
+            checksum += pop(heap);
+            push(heap, keys[BENCH_N + i]);
+        }
+        while (!heap.empty()) checksum += pop(heap);
+        auto end = chrono::high_resolution_clock::now();
+        cout << "  " << name << chrono::duration_cast<chrono::milliseconds>(
+                    end - start).count() << " ms  (checksum " << checksum << ")" << endl;
+    };
+    {
+        MinHeap h;
+        runBench("MinHeap (binary, int)      ", h,
+                 [](MinHeap& q, int v) { q.insert(v); },
+                 [](MinHeap& q) { return q.extractMin(); });
+    }
+    {
+        priority_queue<int, vector<int>, greater<int>> h;
+        runBench("std::priority_queue        ", h,
+                 [](auto& q, int v) { q.push(v); },
+                 [](auto& q) { int v = q.top(); q.pop(); return v; });
+    }
+    {
+        DaryHeap<int, 2> h; h.reserve(BENCH_N);
+        runBench("DaryHeap<int, 2>           ", h,
+                 [](auto& q, int v) { q.insert(v); }, [](auto& q) { return q.extract(); });
+    }
+    {
+        DaryHeap<int, 4> h; h.reserve(BENCH_N);
+        runBench("DaryHeap<int, 4>           ", h,
+                 [](auto& q, int v) { q.insert(v); }, [](auto& q) { return q.extract(); });
+    }
+    {
+        DaryHeap<int, 8> h; h.reserve(BENCH_N);
+        runBench("DaryHeap<int, 8>           ", h,
+                 [](auto& q, int v) { q.insert(v); }, [](auto& q) { return q.extract(); });
+    }
+
+    // --- Demo 7: Indexed priority queue ---
+    cout << "\n--- Indexed Min-PQ Demo ---" << endl;
+    IndexMinPQ<int> ipq(8);
+    string names[] = {"A", "B", "C", "D", "E", "F", "G", "H"};
+    int initial[] = {50, 40, 30, 20, 60, 70, 80, 90};
+    for (int h = 0; h < 8; h++) ipq.insert(h, initial[h]);
+    ipq.decreaseKey(7, 5);    // H: 90 -> 5
+    ipq.increaseKey(3, 65);   // D: 20 -> 65
+    ipq.remove(2);            // drop C
+    cout << "  After H->5, D->65, remove C; contains(C)="
+         << (ipq.contains(2) ? "yes" : "no") << endl;
+    cout << "  Extract sequence: ";
+    while (!ipq.empty()) {
+        int key = ipq.minKey();
+        cout << names[ipq.extractMin()] << "(" << key << ") ";
+    }
+    cout << endl;
+
+    // --- Demo 8: Decrease-key-heavy benchmark (Dijkstra on a random graph) ---
+    // Lazy version pushes a duplicate entry per successful relaxation;
+    // the indexed version calls decreaseKey and holds at most V entries.
+    {
+        const int V = fullBench ? 1000000 : 50000;
+        const int E = 16 * V;
+        cout << "\n--- Dijkstra Benchmark (V=" << V << ", E=" << E << ") ---" << endl;
+        vector<vector<pair<int, int>>> adj(V);
+        unsigned int gseed = 7;
+        auto nextRand = [&gseed]() { gseed = gseed * 1103515245u + 12345u; return gseed >> 1; };
+        for (int e = 0; e < E; e++) {
+            int u = nextRand() % V, v = nextRand() % V;
+            adj[u].push_back({v, (int)(1 + nextRand() % 1000)});
+        }
+        const long long INF = LLONG_MAX;
+
+        auto start = chrono::high_resolution_clock::now();
+        vector<long long> distLazy(V, INF);
+        priority_queue<pair<long long, int>, vector<pair<long long, int>>,
+                       greater<pair<long long, int>>> lazy;
+        size_t maxLazy = 0;
+        distLazy[0] = 0;
+        lazy.push({0, 0});
+        while (!lazy.empty()) {
+            auto [d, u] = lazy.top();
+            lazy.pop();
+            if (d > distLazy[u]) continue;   // stale duplicate
+            for (auto [v, w] : adj[u]) {
+                if (d + w < distLazy[v]) {
+                    distLazy[v] = d + w;
+                    lazy.push({d + w, v});
+                    maxLazy = max(maxLazy, lazy.size());
+                }
+            }
+        }
+        auto mid = chrono::high_resolution_clock::now();
+
+        vector<long long> distIdx(V, INF);
+        IndexMinPQ<long long> idx(V);
+        int maxIdx = 0;
+        long long decreases = 0;
+        distIdx[0] = 0;
+        idx.insert(0, 0);
+        while (!idx.empty()) {
+            int u = idx.extractMin();
+            for (auto [v, w] : adj[u]) {
+                if (distIdx[u] + w < distIdx[v]) {
+                    distIdx[v] = distIdx[u] + w;
+                    if (idx.contains(v)) { idx.decreaseKey(v, distIdx[v]); decreases++; }
+                    else idx.insert(v, distIdx[v]);
+                    maxIdx = max(maxIdx, idx.size());
+                }
+            }
+        }
+        auto end = chrono::high_resolution_clock::now();
+
+        cout << "  Lazy priority_queue: " << chrono::duration_cast<chrono::milliseconds>(
+                    mid - start).count() << " ms, peak entries " << maxLazy << endl;
+        cout << "  IndexMinPQ:          " << chrono::duration_cast<chrono::milliseconds>(
+                    end - mid).count() << " ms, peak entries " << maxIdx
+             << ", decreaseKey calls " << decreases << endl;
+        cout << "  Distances agree: " << (distLazy == distIdx ? "YES" : "NO") << endl;
+    }
+
+    // --- Demo 9: Bottom-up heapsort, blocked build, bulk MinHeap ---
+    cout << "\n--- Bottom-Up Heapsort Demo ---" << endl;
+    vector<int> arr2 = {38, 27, 43, 3, 9, 82, 10};
+    heapsortBottomUp(arr2);
+    printArray(arr2, "  Bottom-up heapsort");
+
+    MinHeap bulk(vector<int>{15, 10, 20, 5, 8, 25, 3});
+    bulk.printHeap("  MinHeap(vector&&)");
+    bulk.insertBatch({1, 30, 7, 12});
+    bulk.printHeap("  After insertBatch {1, 30, 7, 12}");
+    cout << "  Extract sequence: ";
+    while (!bulk.empty()) cout << bulk.extractMin() << " ";
+    cout << endl;
+
+    {
+        const int HN = fullBench ? 20000000 : 2000000;
+        cout << "\n--- Heap Build / Heapsort Benchmark (n=" << HN << ") ---" << endl;
+        vector<int> data(HN);
+        unsigned int hseed = 99;
+        for (int& v : data) { hseed = hseed * 1103515245u + 12345u; v = (int)(hseed >> 1); }
+
+        auto timeMs = [](auto fn) {
+            auto start = chrono::high_resolution_clock::now();
+            fn();
+            auto end = chrono::high_resolution_clock::now();
+            return chrono::duration_cast<chrono::milliseconds>(end - start).count();
+        };
+        vector<int> h1 = data, h2 = data;
+        auto tLevel = timeMs([&] { for (int i = HN / 2 - 1; i >= 0; i--) heapSinkDown(h1, i, HN); });
+        auto tBlock = timeMs([&] { buildHeapBlocked(h2); });
+        bool heapOk = true;
+        for (int i = 1; i < HN; i++) heapOk = heapOk && h2[(i - 1) / 2] >= h2[i];
+        cout << "  Build, level by level (heapSinkDown): " << tLevel << " ms" << endl;
+        cout << "  Build, cache-blocked subtrees:         " << tBlock << " ms"
+             << (heapOk ? "" : "  (NOT A HEAP)") << endl;
+
+        vector<int> s1 = data, s2 = data, ref = data;
+        sort(ref.begin(), ref.end());
+        auto tStd = timeMs([&] { heapsort(s1); });
+        auto tBU = timeMs([&] { heapsortBottomUp(s2); });
+        cout << "  heapsort (2 compares/level):          " << tStd << " ms"
+             << (s1 == ref ? "" : "  (WRONG)") << endl;
+        cout << "  heapsortBottomUp (Floyd bounce):      " << tBU << " ms"
+             << (s2 == ref ? "" : "  (WRONG)") << endl;
+
+        // k inserts into an existing heap: k swims vs one insertBatch
+        const int K = HN / 4;
+        vector<int> base(data.begin(), data.begin() + HN - K);
+        vector<int> extra(data.begin() + HN - K, data.end());
+        MinHeap a{vector<int>(base)}, b{vector<int>(base)};
+        auto tSwim = timeMs([&] { for (int v : extra) a.insert(v); });
+        auto tBatch = timeMs([&] { b.insertBatch(extra); });
+        bool same = true;
+        for (int i = 0; i < 1000 && !a.empty(); i++) same = same && a.extractMin() == b.extractMin();
+        cout << "  " << K << " inserts as k swims:       " << tSwim << " ms" << endl;
+        cout << "  " << K << " inserts as insertBatch:   " << tBatch << " ms"
+             << (same ? "" : "  (WRONG)") << endl;
+    }
+
+    // --- Demo 10: Loser-tree merge over streams ---
+    cout << "\n--- Loser-Tree Merge Demo ---" << endl;
+    {
+        vector<unique_ptr<SortedStream>> owned;
+        vector<SortedStream*> streams;
+        for (auto& a : sortedArrays) {
+            owned.emplace_back(new IteratorStream<vector<int>::const_iterator>(a.begin(), a.end()));
+            streams.push_back(owned.back().get());
+        }
+        int next = 0;  // generator: multiples of 5
+        owned.emplace_back(new GeneratorStream([next](int& out) mutable {
+            if (next > 20) return false;
+            out = next;
+            next += 5;
+            return true;
+        }));
+        streams.push_back(owned.back().get());
+
+        vector<int> out;
+        mergeStreams(streams, [&out](const int* p, size_t n) {
+            out.insert(out.end(), p, p + n);
+        }, 4);
+        printArray(out, "  Arrays + generator {0,5,...,20}");
+    }
+
+    // K sorted files merged with a fixed per-file buffer; the sink only
+    // checks order and counts, so nothing proportional to N is held.
+    {
+        const int K = fullBench ? 10000 : 256;
+        const int PER_FILE = fullBench ? 5000 : 4000;
+        const size_t BUF_INTS = 256;
+        cout << "\n--- Loser-Tree File Merge (K=" << K << " files x " << PER_FILE
+             << " ints, " << BUF_INTS * sizeof(int) << " B buffer per file) ---" << endl;
+
+        namespace fs = std::filesystem;
+        fs::path dir = fs::temp_directory_path() / "lecture05-merge";
+        fs::create_directories(dir);
+        vector<vector<int>> inMemory(K);
+        unsigned int fseed = 5;
+        bool ioOk = true;
+        for (int f = 0; f < K && ioOk; f++) {
+            vector<int>& run = inMemory[f];
+            run.resize(PER_FILE);
+            for (int& v : run) { fseed = fseed * 1103515245u + 12345u; v = (int)(fseed >> 1); }
+            sort(run.begin(), run.end());
+            string path = (dir / (to_string(f) + ".bin")).string();
+            FILE* out = fopen(path.c_str(), "wb");
+            ioOk = out != nullptr && fwrite(run.data(), sizeof(int), run.size(), out) == run.size();
+            if (out != nullptr && fclose(out) != 0) ioOk = false;
+            if (!ioOk) cerr << "  cannot write " << path << endl;
+        }
+
+        auto start = chrono::high_resolution_clock::now();
+        vector<unique_ptr<FileStream>> files;
+        vector<SortedStream*> streams;
+        for (int f = 0; f < K && ioOk; f++) {
+            string path = (dir / (to_string(f) + ".bin")).string();
+            files.emplace_back(new FileStream(path, BUF_INTS));
+            streams.push_back(files.back().get());
+            if (!files.back()->ok()) {
+                cerr << "  cannot open " << path << " (" << K
+                     << " files must be open at once; raise the limit with ulimit -n)" << endl;
+                ioOk = false;
+            }
+        }
+        if (!ioOk) {
+            cout << "  FAILED: file merge skipped" << endl;
+            files.clear();
+        } else {
+            long long count = 0;
+            int last = INT_MIN;
+            bool ordered = true;
+            mergeStreams(streams, [&](const int* p, size_t n) {
+                for (size_t i = 0; i < n; i++) { ordered = ordered && p[i] >= last; last = p[i]; }
+                count += n;
+            });
+            files.clear();
+            auto mid = chrono::high_resolution_clock::now();
+
+            vector<int> heapMerged = mergeKSortedArrays(inMemory);
+            auto end = chrono::high_resolution_clock::now();
+
+            vector<unique_ptr<SortedStream>> ranges;
+            streams.clear();
+            for (auto& run : inMemory) {
+                ranges.emplace_back(new IteratorStream<vector<int>::iterator>(run.begin(), run.end()));
+                streams.push_back(ranges.back().get());
+            }
+            vector<int> treeMerged;
+            treeMerged.reserve(heapMerged.size());
+            mergeStreams(streams, [&treeMerged](const int* p, size_t n) {
+                treeMerged.insert(treeMerged.end(), p, p + n);
+            });
+            auto end2 = chrono::high_resolution_clock::now();
+
+            cout << "  Loser tree from files:         "
+                 << chrono::duration_cast<chrono::milliseconds>(mid - start).count() << " ms, "
+                 << count << " ints, " << (ordered ? "sorted" : "NOT SORTED")
+                 << ", buffers " << K * BUF_INTS * sizeof(int) / 1024 << " KB"
+                 << (count == (long long)K * PER_FILE ? "" : " (WRONG)") << endl;
+            cout << "  mergeKSortedArrays (in memory): "
+                 << chrono::duration_cast<chrono::milliseconds>(end - mid).count() << " ms, "
+                 << "needs all " << (long long)K * PER_FILE * sizeof(int) / (1024 * 1024)
+                 << " MB in RAM plus the output" << endl;
+            cout << "  Loser tree (in memory):        "
+                 << chrono::duration_cast<chrono::milliseconds>(end2 - end).count() << " ms, "
+                 << (treeMerged == heapMerged ? "matches" : "DIFFERS FROM")
+                 << " mergeKSortedArrays" << endl;
+        }
+        fs::remove_all(dir);
+    }
+
+    // --- Demo 11: Parallel multiway merge ---
+    {
+        const int K = 256;
+        const long long TOTAL = fullBench ? (1LL << 28) : (1LL << 23);
+        const int PER = TOTAL / K;
+        unsigned int hw = max(1u, thread::hardware_concurrency());
+        cout << "\n--- Parallel Multiway Merge (K=" << K << ", total " << (long long)K * PER
+             << ", " << hw << " hw threads) ---" << endl;
+        vector<vector<int>> runs(K, vector<int>(PER));
+        unsigned int pseed = 11;
+        for (auto& run : runs) {
+            for (int& v : run) { pseed = pseed * 1103515245u + 12345u; v = (int)((pseed >> 1) % 1000000); }
+            sort(run.begin(), run.end());
+        }
+
+        auto start = chrono::high_resolution_clock::now();
+        vector<int> heapOut = mergeKSortedArrays(runs);
+        auto t0 = chrono::high_resolution_clock::now();
+        cout << "  mergeKSortedArrays:          "
+             << chrono::duration_cast<chrono::milliseconds>(t0 - start).count() << " ms" << endl;
+
+        vector<int> threadCounts;
+        for (int t = 1; t <= (int)max(hw, 4u); t *= 2) threadCounts.push_back(t);
+        if (threadCounts.back() != (int)hw && hw > 4) threadCounts.push_back(hw);
+
+        vector<int> out;
+        for (int threads : threadCounts) {
+            auto s0 = chrono::high_resolution_clock::now();
+            parallelMultiwayMerge(runs, out, threads);
+            auto s1 = chrono::high_resolution_clock::now();
+            cout << "  parallelMultiwayMerge (" << threads << " thr): "
+                 << chrono::duration_cast<chrono::milliseconds>(s1 - s0).count() << " ms"
+                 << (out == heapOut ? "" : "  (WRONG)") << endl;
+        }
+    }
+
+    // --- Demo 12: MultiQueue throughput and rank error ---
+    {
+        unsigned int hw = max(1u, thread::hardware_concurrency());
+        const int OPS = fullBench ? 4000000 : 400000;  // per thread
+        cout << "\n--- MultiQueue vs Locked MinHeap (" << OPS
+             << " insert+extract pairs per thread, " << hw << " hw threads) ---" << endl;
+        if (hw == 1) cout << "  (one hardware thread: contention is measured, scaling is not)" << endl;
+
+        auto keyFor = [](int t, int i) { return (int)(((unsigned)t * 2654435761u + (unsigned)i * 40503u) % 1000000000u); };
+
+        for (int threads = 1; threads <= (int)max(hw, 4u); threads *= 2) {
+            // Baseline: one MinHeap behind one mutex
+            MinHeap locked;
+            mutex lockedMutex;
+            for (int i = 0; i < 100000; i++) locked.insert(keyFor(99, i));
+            auto s0 = chrono::high_resolution_clock::now();
+            {
+                vector<thread> ws;
+                for (int t = 0; t < threads; t++) ws.emplace_back([&, t] {
+                    for (int i = 0; i < OPS; i++) {
+                        lock_guard<mutex> g(lockedMutex);
+                        locked.insert(keyFor(t, i));
+                        locked.extractMin();
+                    }
+                });
+                for (auto& w : ws) w.join();
+            }
+            auto s1 = chrono::high_resolution_clock::now();
+
+            MultiQueue mq(threads);
+            for (int i = 0; i < 100000; i++) mq.insert(keyFor(99, i));
+            auto s2 = chrono::high_resolution_clock::now();
+            {
+                vector<thread> ws;
+                for (int t = 0; t < threads; t++) ws.emplace_back([&, t] {
+                    int out;
+                    for (int i = 0; i < OPS; i++) {
+                        mq.insert(keyFor(t, i));
+                        mq.extractMin(out);
+                    }
+                });
+                for (auto& w : ws) w.join();
+            }
+            auto s3 = chrono::high_resolution_clock::now();
+
+            double opsTotal = 2.0 * OPS * threads;
+            auto mops = [opsTotal](auto a, auto b) {
+                return opsTotal / chrono::duration<double, micro>(b - a).count();
+            };
+            cout << "  " << threads << " thread(s): locked MinHeap " << mops(s0, s1)
+                 << " Mops/s, MultiQueue (" << mq.queueCount() << " heaps) "
+                 << mops(s2, s3) << " Mops/s" << endl;
+        }
+
+        // Rank error: insert a permutation of 0..N-1, then extract and check
+        // how many smaller keys were still present (a Fenwick tree counts them).
+        const int N = 1 << 16, REMOVE = N / 2;
+        cout << "  Rank error over " << REMOVE << " extractions from " << N << " keys:" << endl;
+        for (int heaps : {2, 8, 32, 128}) {
+            MultiQueue mq(heaps / 2);
+            vector<int> perm(N);
+            for (int i = 0; i < N; i++) perm[i] = (int)((i * 40503LL) % N);  // 40503 is odd: a permutation
+            for (int k : perm) mq.insert(k);
+            vector<int> fenwick(N + 1, 0);
+            auto add = [&](int i, int d) { for (i++; i <= N; i += i & -i) fenwick[i] += d; };
+            auto countBelow = [&](int i) { int c = 0; for (; i > 0; i -= i & -i) c += fenwick[i]; return c; };
+            for (int k = 0; k < N; k++) add(k, 1);
+            long long sumRank = 0;
+            int maxRank = 0;
+            for (int r = 0; r < REMOVE; r++) {
+                int key;
+                mq.extractMin(key);
+                int rank = countBelow(key);  // keys smaller than the one removed
+                sumRank += rank;
+                maxRank = max(maxRank, rank);
+                add(key, -1);
+            }
+            cout << "    " << heaps << " heaps: mean rank error " << (double)sumRank / REMOVE
+                 << ", max " << maxRank << endl;
+        }
+    }
+
+    // --- Demo 13: Radix heap and pairing heap ---
+    cout << "\n--- Radix Heap / Pairing Heap Demo ---" << endl;
+    {
+        RadixHeap rh;
+        PairingHeap ph, other;
+        for (int v : vals) { rh.insert(v); ph.insert(v); }
+        rh.printHeap("  Radix heap");
+        ph.printHeap("  Pairing heap");
+        cout << "  Radix extract: " << rh.extractMin() << " " << rh.extractMin();
+        rh.insert(6);  // monotone: any key >= 5 may still be inserted
+        cout << ", insert 6, then:";
+        while (!rh.empty()) cout << " " << rh.extractMin();
+        cout << endl;
+        for (int v : {4, 1, 30}) other.insert(v);
+        ph.meld(other);
+        cout << "  Pairing heap after meld {4, 1, 30}:";
+        while (!ph.empty()) cout << " " << ph.extractMin();
+        cout << endl;
+    }
+
+    // Hold model of a discrete-event simulation: keep N pending events;
+    // repeatedly pop the earliest and schedule a new one at now + delay.
+    {
+        const int EVENTS = fullBench ? 1000000 : 100000;
+        const int STEPS = fullBench ? 20000000 : 2000000;
+        cout << "\n--- Event Simulation Trace (" << EVENTS << " pending, "
+             << STEPS << " pop+schedule steps) ---" << endl;
+        vector<int> delays(STEPS + EVENTS);
+        unsigned int dseed = 3;
+        for (int& d : delays) {
+            dseed = dseed * 1103515245u + 12345u;
+            // Mostly short timeouts, some long ones
+            d = (dseed >> 16) % 8 == 0 ? (int)((dseed >> 8) % 100000) : (int)((dseed >> 8) % 1000);
+        }
+        auto simulate = [&](auto& q, const string& name) {
+            auto start = chrono::high_resolution_clock::now();
+            for (int i = 0; i < EVENTS; i++) q.insert(delays[i]);
+            long long checksum = 0;
+            for (int i = 0; i < STEPS; i++) {
+                int now = q.extractMin();
+                checksum += now;
+                q.insert(now + delays[EVENTS + i]);
+            }
+            auto end = chrono::high_resolution_clock::now();
+            cout << "  " << name << chrono::duration_cast<chrono::milliseconds>(
+                        end - start).count() << " ms  (checksum " << checksum << ")" << endl;
+        };
+        { MinHeap q;          simulate(q, "MinHeap          "); }
+        { DaryHeap<int, 4> q; q.reserve(EVENTS + 1);
+          struct Adapter { DaryHeap<int, 4>& h; void insert(int v) { h.insert(v); }
+                           int extractMin() { return h.extract(); } } a{q};
+          simulate(a, "DaryHeap<int, 4> "); }
+        { RadixHeap q;        simulate(q, "RadixHeap        "); }
+        { PairingHeap q;      simulate(q, "PairingHeap      "); }
+    }
+
+    // --- Demo 14: Streaming top-K and heavy hitters ---
+    cout << "\n--- Streaming Top-K Demo ---" << endl;
+    {
+        StreamingTopK top3(3), bottom3(3, false);
+        int stream[] = {15, 10, 20, 5, 8, 25, 3, 42, -7, 18};
+        for (int x : stream) { top3.offer(x); bottom3.offer(x); }
+        printArray(top3.result(), "  Top 3 of {15,10,20,5,8,25,3,42,-7,18}");
+        printArray(bottom3.result(), "  Bottom 3");
+
+        const int SN = fullBench ? 100000000 : 10000000;
+        const int TOPK = 100;
+#ifdef __AVX2__
+        cout << "  Stream of " << SN << " ints, K=" << TOPK << " (AVX2 filter enabled):" << endl;
+#else
+        cout << "  Stream of " << SN << " ints, K=" << TOPK << " (scalar filter):" << endl;
+#endif
+        vector<int> data(SN);
+        unsigned int tseed = 17;
+        for (int& v : data) { tseed = tseed * 1103515245u + 12345u; v = (int)(tseed >> 1); }
+        vector<int> expect(data);
+        nth_element(expect.begin(), expect.begin() + TOPK - 1, expect.end(), greater<int>());
+        sort(expect.begin(), expect.begin() + TOPK, greater<int>());
+        expect.resize(TOPK);
+
+        auto timeMs = [](auto fn) {
+            auto start = chrono::high_resolution_clock::now();
+            fn();
+            return chrono::duration_cast<chrono::milliseconds>(
+                chrono::high_resolution_clock::now() - start).count();
+        };
+        // Baseline without the threshold check: insert everything, trim to K
+        MinHeap naive;
+        auto tNaive = timeMs([&] {
+            for (int x : data) { naive.insert(x); if (naive.size() > TOPK) naive.extractMin(); }
+        });
+        StreamingTopK one(TOPK), batched(TOPK);
+        auto tOne = timeMs([&] { for (int x : data) one.offer(x); });
+        auto tBatch = timeMs([&] {
+            for (int i = 0; i < SN; i += 4096) batched.offerBatch(&data[i], min(4096, SN - i));
+        });
+        cout << "    insert-then-trim MinHeap: " << tNaive << " ms" << endl;
+        cout << "    offer (threshold reject): " << tOne << " ms, reject rate "
+             << one.rejectRate() * 100 << "%" << (one.result() == expect ? "" : "  (WRONG)") << endl;
+        cout << "    offerBatch (filtered):    " << tBatch << " ms"
+             << (batched.result() == expect ? "" : "  (WRONG)") << endl;
+
+        unsigned int hw = max(1u, thread::hardware_concurrency());
+        for (int threads : {2, (int)max(hw, 4u)}) {
+            ConcurrentTopK shared(TOPK);
+            vector<int> merged;
+            auto tPar = timeMs([&] {
+                vector<thread> ws;
+                for (int t = 0; t < threads; t++) ws.emplace_back([&, t] {
+                    long long lo = (long long)SN * t / threads, hi = (long long)SN * (t + 1) / threads;
+                    for (long long i = lo; i < hi; i += 4096)
+                        shared.offerBatch(&data[i], (size_t)min(4096LL, hi - i));
+                });
+                for (auto& w : ws) w.join();
+                merged = shared.result();
+            });
+            cout << "    ConcurrentTopK, " << threads << " threads: " << tPar << " ms"
+                 << (merged == expect ? "" : "  (WRONG)") << endl;
+        }
+    }
+
+    cout << "\n--- Heavy Hitters (count-min sketch + top-K) ---" << endl;
+    {
+        // Zipf(1.1) stream over 1M distinct items
+        const int ITEMS = 1000000, HN2 = fullBench ? 50000000 : 5000000;
+        vector<double> cdf(ITEMS);
+        double total = 0;
+        for (int i = 0; i < ITEMS; i++) { total += 1.0 / pow(i + 1, 1.1); cdf[i] = total; }
+        vector<int> truth(ITEMS, 0);
+        HeavyHitters hh(10, 1 << 16, 4);
+        unsigned int zseed = 23;
+        for (int i = 0; i < HN2; i++) {
+            zseed = zseed * 1103515245u + 12345u;
+            double u = (zseed >> 1) / 2147483648.0 * total;
+            int item = lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin();
+            truth[item]++;
+            hh.offer(item * 31 + 13);  // spread item ids
+        }
+        cout << "  " << HN2 << " events; sketch 4 x 65536 counters" << endl;
+        cout << "  Item        Estimated      True" << endl;
+        for (auto& [key, est] : hh.result()) {
+            int item = (key - 13) / 31;
+            cout << "  " << left << setw(10) << key << right << setw(11) << est
+                 << setw(10) << truth[item] << endl;
+        }
+    }
+
+    // --- Demo 15: Timing wheel vs heap timers ---
+    cout << "\n--- Timing Wheel Demo (resolution 10 ms/tick, 4 levels x 8 slots) ---" << endl;
+    {
+        TimingWheel wheel(10, 3, 4);
+        wheel.schedule(25, 1);     // fires at tick 3 (30 ms)
+        wheel.schedule(640, 2);                   // level 2, cascades down
+        long long h3 = wheel.schedule(100, 3);
+        wheel.schedule(50000, 4);                 // beyond 8^4 ticks: overflow list
+        wheel.cancel(h3);
+        cout << "  Scheduled 4 timers, cancelled #3 (cancel again -> "
+             << (wheel.cancel(h3) ? "true" : "false") << ")" << endl;
+        cout << "  Fired:";
+        while (wheel.pending() > 0)
+            wheel.tick([&](int id) { cout << " #" << id << "@" << wheel.currentTime() << "ms"; });
+        cout << endl;
+    }
+
+    // Trace: every tick schedules a few timeouts and the matching replies
+    // cancel most of them shortly after (90% never fire).
+    {
+        const int TICKS = fullBench ? 2000000 : 200000;
+        const int PER_TICK = 8;
+        cout << "\n--- Timer Trace (" << TICKS << " ticks, " << PER_TICK
+             << " schedules/tick, ~90% cancelled) ---" << endl;
+        struct Op { int delay; int cancelAfter; };  // cancelAfter < 0: never cancelled
+        vector<Op> ops((size_t)TICKS * PER_TICK);
+        unsigned int wseed = 31;
+        for (auto& op : ops) {
+            wseed = wseed * 1103515245u + 12345u;
+            op.delay = 1000 + (int)((wseed >> 8) % 30000);            // 1-31 s timeouts
+            wseed = wseed * 1103515245u + 12345u;
+            op.cancelAfter = (wseed >> 8) % 10 == 0 ? -1 : (int)((wseed >> 12) % 200);
+        }
+
+        auto runTrace = [&](auto schedule, auto cancel, auto advance, const string& name) {
+            // cancels[t] = handles to cancel at tick t (ring buffer of 256 ticks)
+            vector<vector<long long>> cancels(256);
+            long long fired = 0, checksum = 0;
+            auto onFire = [&](int id) { fired++; checksum += id; };
+            auto start = chrono::high_resolution_clock::now();
+            for (int t = 0; t < TICKS; t++) {
+                for (long long h : cancels[t & 255]) cancel(h);
+                cancels[t & 255].clear();
+                for (int j = 0; j < PER_TICK; j++) {
+                    int id = t * PER_TICK + j;
+                    const Op& op = ops[id];
+                    long long h = schedule(op.delay, id);
+                    if (op.cancelAfter >= 0) cancels[(t + 1 + op.cancelAfter) & 255].push_back(h);
+                }
+                advance(onFire);
+            }
+            auto end = chrono::high_resolution_clock::now();
+            cout << "  " << name << " " << chrono::duration_cast<chrono::milliseconds>(end - start).count()
+                 << " ms, fired " << fired << " (checksum " << checksum << ")" << endl;
+        };
+
+        {
+            TimingWheel wheel;
+            runTrace([&](int d, int id) { return wheel.schedule(d, id); },
+                     [&](long long h) { wheel.cancel(h); },
+                     [&](auto& fire) { wheel.tick(fire); },
+                     "TimingWheel              ");
+        }
+        {
+            // Eager cancel: indexed heap keyed by timer id
+            IndexMinPQ<long long> pq((size_t)TICKS * PER_TICK);
+            long long now = 0;
+            runTrace([&](int d, int id) { pq.insert(id, now + d); return (long long)id; },
+                     [&](long long h) { if (pq.contains((int)h)) pq.remove((int)h); },
+                     [&](auto& fire) {
+                         now++;
+                         while (!pq.empty() && pq.minKey() <= now) fire(pq.extractMin());
+                     },
+                     "IndexMinPQ (eager cancel)");
+        }
+        {
+            // Lazy cancel: heap of (expiry, id), cancelled ids skipped on pop
+            DaryHeap<pair<long long, int>, 4> heap;
+            vector<char> cancelled((size_t)TICKS * PER_TICK, 0);
+            long long now = 0;
+            runTrace([&](int d, int id) { heap.insert({now + d, id}); return (long long)id; },
+                     [&](long long h) { cancelled[h] = 1; },
+                     [&](auto& fire) {
+                         now++;
+                         while (!heap.empty() && heap.peek().first <= now) {
+                             int id = heap.extract().second;
+                             if (!cancelled[id]) { cancelled[id] = 1; fire(id); }
+                         }
+                     },
+                     "DaryHeap (lazy cancel)   ");
+        }
+    }
+
     return 0;
 }
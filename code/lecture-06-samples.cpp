@@ -8,12 +8,44 @@
 //   3. Find min/max in BST
 //   4. BST successor and predecessor
 //   5. Demo building a BST and showing all operations
+//   6. Arena-backed BST (32-bit child indices, free list, O(1) freeTree)
+//   7. O(n) bulk load of a balanced BST from sorted keys, with an optional
+//      van Emde Boas node layout
+//   8. Iterative (stack-safe) insert/search/delete/traversals/free and
+//      O(1)-space Morris in-order traversal
+//   9. Floor/ceiling, lazy range iterator, rangeCount, and a size-augmented
+//      BST with O(log n) rank and range counts
+//  10. Concurrent read-mostly BST: lock-free readers, serialized writers,
+//      epoch-based reclamation
+//  11. Splay tree mode (top-down splaying) and semi-splaying for skewed
+//      (Zipf) access patterns
+//  12. Scapegoat tree mode: alpha-weight-balance with flatten/rebuild and
+//      no extra per-node fields
+//
+// Compile: g++ -std=c++17 -O2 -pthread -o lecture-06 lecture-06-samples.cpp
+// Run:     ./lecture-06          (demo, small benchmarks)
+//          ./lecture-06 --bench  (full-size benchmarks)
+//          ./lecture-06 --stress [n]  (build/traverse/free an n-node degenerate
+//                                      tree, default 100M; needs ~3.5 GB)
+//          ./lecture-06 --concurrent-stress [threads] [ms]
+//                       (reader/writer check of ConcurrentBST; build with
+//                        -fsanitize=thread to run it under ThreadSanitizer)
 // ============================================================================
 
 #include <iostream>
 #include <vector>
 #include <string>
 #include <functional>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <climits>
+#include <cstdlib>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <cmath>
 
 using namespace std;
 
@@ -170,6 +202,192 @@ BSTNode* predecessor(BSTNode* root, int key) {
     return pred;
 }
 
+// === SECTION: Iterative Operations ===
+// The recursive functions above use one stack frame per level. That is
+// fine for a balanced tree (depth ~ lg n) but a degenerate tree -- e.g.
+// keys inserted in sorted order -- has depth n, and a few hundred thousand
+// frames overflow the default 8 MB stack. The versions below keep any
+// per-level state on the heap (or nowhere at all), so they work at any depth.
+
+// Walk down a pointer to the link that should hold key, then fill it.
+BSTNode* insertIterative(BSTNode* root, int key) {
+    BSTNode** link = &root;
+    while (*link != nullptr) {
+        if (key < (*link)->key)      link = &(*link)->left;
+        else if (key > (*link)->key) link = &(*link)->right;
+        else return root;            // duplicate
+    }
+    *link = new BSTNode(key);
+    return root;
+}
+
+BSTNode* searchIterative(BSTNode* root, int key) {
+    while (root != nullptr && root->key != key)
+        root = key < root->key ? root->left : root->right;
+    return root;
+}
+
+// Same three cases as deleteNode, tracking the parent link instead of
+// returning subtrees up the call chain.
+BSTNode* deleteNodeIterative(BSTNode* root, int key) {
+    BSTNode** link = &root;
+    while (*link != nullptr && (*link)->key != key)
+        link = key < (*link)->key ? &(*link)->left : &(*link)->right;
+    BSTNode* node = *link;
+    if (node == nullptr) return root;
+
+    if (node->left != nullptr && node->right != nullptr) {
+        // Two children: copy the successor's key, then unlink the successor
+        BSTNode** succLink = &node->right;
+        while ((*succLink)->left != nullptr) succLink = &(*succLink)->left;
+        BSTNode* succ = *succLink;
+        node->key = succ->key;
+        *succLink = succ->right;
+        delete succ;
+    } else {
+        *link = node->left != nullptr ? node->left : node->right;
+        delete node;
+    }
+    return root;
+}
+
+// Explicit-stack traversals: O(h) heap memory instead of O(h) call stack.
+void inOrderIterative(BSTNode* root, vector<int>& result) {
+    vector<BSTNode*> stack;
+    BSTNode* curr = root;
+    while (curr != nullptr || !stack.empty()) {
+        while (curr != nullptr) { stack.push_back(curr); curr = curr->left; }
+        curr = stack.back();
+        stack.pop_back();
+        result.push_back(curr->key);
+        curr = curr->right;
+    }
+}
+
+void preOrderIterative(BSTNode* root, vector<int>& result) {
+    if (root == nullptr) return;
+    vector<BSTNode*> stack = {root};
+    while (!stack.empty()) {
+        BSTNode* node = stack.back();
+        stack.pop_back();
+        result.push_back(node->key);
+        if (node->right != nullptr) stack.push_back(node->right);   // left is popped first
+        if (node->left != nullptr) stack.push_back(node->left);
+    }
+}
+
+// Post-order with one stack: a node is emitted once its right subtree is
+// done, i.e. when we come back up from the right child (or it has none).
+void postOrderIterative(BSTNode* root, vector<int>& result) {
+    vector<BSTNode*> stack;
+    BSTNode* curr = root;
+    BSTNode* lastVisited = nullptr;
+    while (curr != nullptr || !stack.empty()) {
+        while (curr != nullptr) { stack.push_back(curr); curr = curr->left; }
+        BSTNode* top = stack.back();
+        if (top->right != nullptr && top->right != lastVisited) {
+            curr = top->right;
+        } else {
+            result.push_back(top->key);
+            lastVisited = top;
+            stack.pop_back();
+        }
+    }
+}
+
+// Morris in-order traversal: O(1) extra space. Before descending into a
+// left subtree, make that subtree's rightmost node (the in-order
+// predecessor) point back to the current node. Reaching the current node
+// again through that thread means the left subtree is done: remove the
+// thread, visit, go right. Every edge is walked at most three times, so
+// the traversal is O(n), and the tree is restored when it finishes.
+template <typename Visit>
+void morrisForEach(BSTNode* root, Visit visit) {
+    BSTNode* curr = root;
+    while (curr != nullptr) {
+        if (curr->left == nullptr) {
+            visit(curr->key);
+            curr = curr->right;
+            continue;
+        }
+        BSTNode* pred = curr->left;
+        while (pred->right != nullptr && pred->right != curr) pred = pred->right;
+        if (pred->right == nullptr) {
+            pred->right = curr;        // thread back to curr
+            curr = curr->left;
+        } else {
+            pred->right = nullptr;     // left subtree done: remove thread
+            visit(curr->key);
+            curr = curr->right;
+        }
+    }
+}
+
+void morrisInOrder(BSTNode* root, vector<int>& result) {
+    morrisForEach(root, [&](int key) { result.push_back(key); });
+}
+
+// Free in O(1) space: rotate left children up until the root has none,
+// then delete the root and continue with its right subtree.
+void freeTreeIterative(BSTNode* root) {
+    while (root != nullptr) {
+        if (root->left != nullptr) {
+            BSTNode* left = root->left;
+            root->left = left->right;
+            left->right = root;
+            root = left;
+        } else {
+            BSTNode* right = root->right;
+            delete root;
+            root = right;
+        }
+    }
+}
+
+// Builds an n-node degenerate tree (the right spine produced by inserting
+// 0..n-1 in sorted order, linked directly since sorted insert is O(n^2)),
+// then searches, inserts and deletes at its deep end, traverses it with
+// Morris in-order and frees it, all without recursion. Returns 0 on success.
+int runDegenerateStress(int n) {
+    auto t = chrono::high_resolution_clock::now();
+    auto lap = [&](const string& what) {
+        auto now = chrono::high_resolution_clock::now();
+        cout << "  " << what << ": "
+             << chrono::duration_cast<chrono::milliseconds>(now - t).count() << " ms" << endl;
+        t = now;
+    };
+    cout << "--- Degenerate BST stress (" << n << " nodes) ---" << endl;
+
+    BSTNode* root = nullptr;
+    BSTNode* tail = nullptr;
+    for (int i = 0; i < n; i++) {
+        BSTNode* node = new BSTNode(2 * i);
+        if (tail == nullptr) root = node; else tail->right = node;
+        tail = node;
+    }
+    lap("build right spine");
+
+    bool ok = searchIterative(root, 2 * (n - 1)) != nullptr
+           && searchIterative(root, 2 * n) == nullptr;
+    root = insertIterative(root, 2 * n - 1);         // depth n
+    root = deleteNodeIterative(root, 2 * (n - 1));   // one child case at depth n-1
+    root = insertIterative(root, 2 * (n - 1));
+    lap("search/insert/delete at depth n");
+
+    long long count = 0;
+    int prev = INT_MIN;
+    bool sorted = true;
+    morrisForEach(root, [&](int key) { sorted &= key > prev; prev = key; count++; });
+    ok &= sorted && count == n + 1;
+    lap("Morris in-order traversal");
+
+    freeTreeIterative(root);
+    lap("freeTreeIterative");
+
+    cout << "  " << (ok ? "OK" : "FAILED") << endl;
+    return ok ? 0 : 1;
+}
+
 // === SECTION: Utility ===
 
 void printVector(const vector<int>& v, const string& label) {
@@ -199,9 +417,953 @@ void freeTree(BSTNode* root) {
     delete root;
 }
 
+// === SECTION: Range Queries ===
+// floor(key): largest key <= key.  ceiling(key): smallest key >= key.
+// Same walk as successor/predecessor, but the key itself qualifies.
+
+BSTNode* floor(BSTNode* root, int key) {
+    BSTNode* best = nullptr;
+    while (root != nullptr) {
+        if (key == root->key) return root;
+        if (key < root->key) {
+            root = root->left;
+        } else {
+            best = root;          // root->key < key: candidate, look for larger
+            root = root->right;
+        }
+    }
+    return best;
+}
+
+BSTNode* ceiling(BSTNode* root, int key) {
+    BSTNode* best = nullptr;
+    while (root != nullptr) {
+        if (key == root->key) return root;
+        if (key > root->key) {
+            root = root->right;
+        } else {
+            best = root;          // root->key > key: candidate, look for smaller
+            root = root->left;
+        }
+    }
+    return best;
+}
+
+// Lazy in-order iterator over keys in [lo, hi]. Seeking to lo is the
+// ceiling walk, remembering every node where we went left (those are the
+// ancestors still to be visited). Stepping is successor(): the min of the
+// right subtree if there is one, else the nearest remembered ancestor.
+// Keeping that path on a stack instead of calling successor(root, key)
+// each time makes a step amortized O(1), so a scan of k keys costs
+// O(log n + k) time and O(h) memory, with no copy of the tree.
+class RangeIterator {
+    vector<BSTNode*> path;   // nodes whose left subtree we are inside
+    int hi;
+
+    void pushLeft(BSTNode* node) {
+        while (node != nullptr) { path.push_back(node); node = node->left; }
+    }
+
+public:
+    RangeIterator(BSTNode* root, int lo, int hi) : hi(hi) {
+        while (root != nullptr) {
+            if (root->key < lo) {
+                root = root->right;
+            } else {
+                path.push_back(root);
+                root = root->left;
+            }
+        }
+    }
+
+    bool valid() const { return !path.empty() && path.back()->key <= hi; }
+    int key() const { return path.back()->key; }
+
+    void next() {
+        BSTNode* node = path.back();
+        path.pop_back();
+        pushLeft(node->right);
+    }
+};
+
+// Number of keys in [lo, hi] in O(log n + k) by walking the iterator.
+int rangeCount(BSTNode* root, int lo, int hi) {
+    int count = 0;
+    for (RangeIterator it(root, lo, hi); it.valid(); it.next()) count++;
+    return count;
+}
+
+// Size-augmented BST: each node also stores the number of nodes in its
+// subtree (Sedgwick's N field). insert/delete keep it up to date on the
+// way back up; in exchange rankOf(key) -- the number of keys < key -- is a
+// single root-to-leaf walk, and rangeCount becomes O(log n) regardless of
+// how many keys fall in the range.
+struct SizedBSTNode {
+    int key;
+    int size;
+    SizedBSTNode* left;
+    SizedBSTNode* right;
+
+    SizedBSTNode(int k) : key(k), size(1), left(nullptr), right(nullptr) {}
+};
+
+int size(SizedBSTNode* node) { return node == nullptr ? 0 : node->size; }
+
+SizedBSTNode* insert(SizedBSTNode* root, int key) {
+    if (root == nullptr) return new SizedBSTNode(key);
+    if (key < root->key)
+        root->left = insert(root->left, key);
+    else if (key > root->key)
+        root->right = insert(root->right, key);
+    root->size = 1 + size(root->left) + size(root->right);
+    return root;
+}
+
+SizedBSTNode* deleteMin(SizedBSTNode* root, SizedBSTNode*& minNode) {
+    if (root->left == nullptr) { minNode = root; return root->right; }
+    root->left = deleteMin(root->left, minNode);
+    root->size = 1 + size(root->left) + size(root->right);
+    return root;
+}
+
+// Hibbard deletion: a node with two children is replaced by its successor.
+SizedBSTNode* deleteNode(SizedBSTNode* root, int key) {
+    if (root == nullptr) return nullptr;
+    if (key < root->key) {
+        root->left = deleteNode(root->left, key);
+    } else if (key > root->key) {
+        root->right = deleteNode(root->right, key);
+    } else {
+        SizedBSTNode* left = root->left;
+        SizedBSTNode* right = root->right;
+        delete root;
+        if (left == nullptr) return right;
+        if (right == nullptr) return left;
+        SizedBSTNode* succ;
+        right = deleteMin(right, succ);
+        succ->left = left;
+        succ->right = right;
+        root = succ;
+    }
+    root->size = 1 + size(root->left) + size(root->right);
+    return root;
+}
+
+bool contains(SizedBSTNode* root, int key) {
+    while (root != nullptr && root->key != key)
+        root = key < root->key ? root->left : root->right;
+    return root != nullptr;
+}
+
+// Number of keys strictly less than key.
+int rankOf(SizedBSTNode* root, int key) {
+    int r = 0;
+    while (root != nullptr) {
+        if (key < root->key) {
+            root = root->left;
+        } else if (key > root->key) {
+            r += 1 + size(root->left);
+            root = root->right;
+        } else {
+            return r + size(root->left);
+        }
+    }
+    return r;
+}
+
+int rangeCount(SizedBSTNode* root, int lo, int hi) {
+    if (lo > hi) return 0;
+    return rankOf(root, hi) - rankOf(root, lo) + (contains(root, hi) ? 1 : 0);
+}
+
+void freeTree(SizedBSTNode* root) {
+    if (root == nullptr) return;
+    freeTree(root->left);
+    freeTree(root->right);
+    delete root;
+}
+
+// === SECTION: Arena BST ===
+// The pointer BST above calls new/delete for every key, scattering 24-byte
+// nodes (plus allocator headers) across the heap. The arena version keeps
+// all nodes of a tree in one vector and links them with 32-bit indices:
+// 12 bytes per node, no per-node allocation, and better locality because
+// nodes inserted together sit together.
+//
+// Deleted slots go on a free list threaded through their left field and
+// are reused by later inserts. Because the arena owns every node of the
+// tree, freeTree just resets the arena: O(1) instead of a full traversal.
+// The free functions mirror the pointer API, with a node index (NIL for
+// an empty subtree) in place of BSTNode*. One tree per arena.
+
+const int NIL = -1;
+
+struct ArenaNode {
+    int key;
+    int32_t left;
+    int32_t right;
+};
+
+struct BSTArena {
+    vector<ArenaNode> nodes;
+    int freeList = NIL;
+    int live = 0;
+
+    int alloc(int key) {
+        int i;
+        if (freeList != NIL) {
+            i = freeList;
+            freeList = nodes[i].left;
+            nodes[i] = {key, NIL, NIL};
+        } else {
+            i = nodes.size();
+            nodes.push_back({key, NIL, NIL});
+        }
+        live++;
+        return i;
+    }
+
+    void release(int i) {
+        nodes[i].left = freeList;
+        freeList = i;
+        live--;
+    }
+
+    void reserve(int n) { nodes.reserve(n); }
+    size_t bytes() const { return nodes.capacity() * sizeof(ArenaNode); }
+
+    ArenaNode& operator[](int i) { return nodes[i]; }
+    const ArenaNode& operator[](int i) const { return nodes[i]; }
+};
+
+// Insert a key. Returns the (possibly new) root index.
+int insert(BSTArena& a, int root, int key) {
+    if (root == NIL) return a.alloc(key);
+    int curr = root;
+    while (true) {
+        if (key < a[curr].key) {
+            if (a[curr].left == NIL) { int n = a.alloc(key); a[curr].left = n; break; }
+            curr = a[curr].left;
+        } else if (key > a[curr].key) {
+            if (a[curr].right == NIL) { int n = a.alloc(key); a[curr].right = n; break; }
+            curr = a[curr].right;
+        } else {
+            break;  // duplicate
+        }
+    }
+    return root;
+}
+
+// Returns the node index holding key, or NIL.
+int search(const BSTArena& a, int root, int key) {
+    while (root != NIL && a[root].key != key)
+        root = key < a[root].key ? a[root].left : a[root].right;
+    return root;
+}
+
+int findMin(const BSTArena& a, int root) {
+    if (root == NIL) return NIL;
+    while (a[root].left != NIL) root = a[root].left;
+    return root;
+}
+
+int findMax(const BSTArena& a, int root) {
+    if (root == NIL) return NIL;
+    while (a[root].right != NIL) root = a[root].right;
+    return root;
+}
+
+// Delete a key. Returns the (possibly new) root index.
+// Same three cases as deleteNode above; the two-child case copies the
+// successor's key and splices the successor out of the right subtree.
+int deleteNode(BSTArena& a, int root, int key) {
+    int parent = NIL, curr = root;
+    while (curr != NIL && a[curr].key != key) {
+        parent = curr;
+        curr = key < a[curr].key ? a[curr].left : a[curr].right;
+    }
+    if (curr == NIL) return root;
+
+    if (a[curr].left != NIL && a[curr].right != NIL) {
+        // Two children: find successor (min of right) and its parent
+        int succParent = curr, succ = a[curr].right;
+        while (a[succ].left != NIL) { succParent = succ; succ = a[succ].left; }
+        a[curr].key = a[succ].key;
+        if (succParent == curr) a[succParent].right = a[succ].right;
+        else                    a[succParent].left = a[succ].right;
+        a.release(succ);
+        return root;
+    }
+
+    // Zero or one child: replace node with its child
+    int child = a[curr].left != NIL ? a[curr].left : a[curr].right;
+    if (parent == NIL)              root = child;
+    else if (a[parent].left == curr) a[parent].left = child;
+    else                             a[parent].right = child;
+    a.release(curr);
+    return root;
+}
+
+// Explicit index stack, as in inOrderIterative, so any depth is safe.
+void inOrder(const BSTArena& a, int root, vector<int>& result) {
+    vector<int> stack;
+    int curr = root;
+    while (curr != NIL || !stack.empty()) {
+        while (curr != NIL) { stack.push_back(curr); curr = a[curr].left; }
+        curr = stack.back();
+        stack.pop_back();
+        result.push_back(a[curr].key);
+        curr = a[curr].right;
+    }
+}
+
+// Free all nodes in O(1): the arena owns them, so drop the whole block.
+void freeTree(BSTArena& a, int& root) {
+    a.nodes.clear();
+    a.freeList = NIL;
+    a.live = 0;
+    root = NIL;
+}
+
+// === SECTION: Bulk Loading ===
+// Inserting n keys one by one costs O(n log n) on random input and O(n^2)
+// on sorted input, where every insert walks down the right spine. Given
+// sorted, distinct keys we can build a perfectly balanced tree directly:
+// the middle key is the root, and the two halves recursively form the left
+// and right subtrees. Each key is visited once, so the build is O(n), and
+// the recursion depth is only lg n.
+
+BSTNode* buildBalancedRange(const vector<int>& sorted, int lo, int hi) {
+    if (lo >= hi) return nullptr;
+    int mid = lo + (hi - lo) / 2;
+    BSTNode* node = new BSTNode(sorted[mid]);
+    node->left = buildBalancedRange(sorted, lo, mid);
+    node->right = buildBalancedRange(sorted, mid + 1, hi);
+    return node;
+}
+
+BSTNode* buildBalanced(const vector<int>& sorted) {
+    return buildBalancedRange(sorted, 0, sorted.size());
+}
+
+// Arena version: nodes are allocated in pre-order, so a parent and its left
+// child are adjacent. Expects an empty arena. Returns the root index.
+int buildBalancedRange(BSTArena& a, const vector<int>& sorted, int lo, int hi) {
+    if (lo >= hi) return NIL;
+    int mid = lo + (hi - lo) / 2;
+    int node = a.alloc(sorted[mid]);
+    int left = buildBalancedRange(a, sorted, lo, mid);
+    int right = buildBalancedRange(a, sorted, mid + 1, hi);
+    a[node].left = left;
+    a[node].right = right;
+    return node;
+}
+
+int buildBalanced(BSTArena& a, const vector<int>& sorted) {
+    a.reserve(sorted.size());
+    return buildBalancedRange(a, sorted, 0, sorted.size());
+}
+
+// Van Emde Boas layout: pre-order still spreads a root-to-leaf path over
+// ~lg n cache lines once the tree is large. The vEB layout splits a tree of
+// height h into a top tree of height h/2 and the bottom subtrees hanging
+// from it, stores the top tree first and then each bottom tree, each one
+// laid out the same way recursively. Any root-to-leaf path then crosses
+// O(log_B n) blocks for every block size B at once, without knowing B.
+// The tree shape is the same as buildBalanced; only the slot order changes.
+// Cost is O(n log log n) for the fringe lists plus an O(n) linking pass.
+
+// Assigns slots to the top `height` levels of the subtree over
+// sorted[lo, hi) and appends the ranges hanging below them to fringe.
+void vebAssign(vector<int>& slotOf, int& nextSlot, int lo, int hi, int height,
+               vector<pair<int, int>>& fringe) {
+    if (lo >= hi) return;
+    int mid = lo + (hi - lo) / 2;
+    if (height == 1) {
+        slotOf[mid] = nextSlot++;
+        if (lo < mid) fringe.push_back({lo, mid});
+        if (mid + 1 < hi) fringe.push_back({mid + 1, hi});
+        return;
+    }
+    int top = height / 2, bottom = height - top;
+    vector<pair<int, int>> middle;
+    vebAssign(slotOf, nextSlot, lo, hi, top, middle);
+    for (auto& r : middle) vebAssign(slotOf, nextSlot, r.first, r.second, bottom, fringe);
+}
+
+int vebLink(BSTArena& a, const vector<int>& sorted, const vector<int>& slotOf, int lo, int hi) {
+    if (lo >= hi) return NIL;
+    int mid = lo + (hi - lo) / 2;
+    int node = slotOf[mid];
+    a[node] = {sorted[mid], vebLink(a, sorted, slotOf, lo, mid),
+               vebLink(a, sorted, slotOf, mid + 1, hi)};
+    return node;
+}
+
+// Expects an empty arena. Returns the root index (always slot 0).
+int buildBalancedVEB(BSTArena& a, const vector<int>& sorted) {
+    int n = sorted.size();
+    if (n == 0) return NIL;
+    int height = 0;
+    while ((1LL << height) <= n) height++;   // ceil(lg(n + 1))
+    vector<int> slotOf(n);
+    int nextSlot = 0;
+    vector<pair<int, int>> fringe;
+    vebAssign(slotOf, nextSlot, 0, n, height, fringe);
+    a.nodes.resize(n);
+    a.live = n;
+    return vebLink(a, sorted, slotOf, 0, n);
+}
+
+// === SECTION: Splay Trees ===
+// A splay tree is a plain BST (same BSTNode, no extra fields) that moves
+// every accessed key to the root with rotations. Hot keys therefore stay
+// near the top, and any sequence of m operations costs O(m log n)
+// amortized. For skewed access the number of comparisons (path length)
+// is close to the entropy of the access distribution. That bound is not
+// wall-clock latency: every access also rewrites its path, so even lookups
+// write to memory, and on the Zipf benchmark below neither splay mode
+// beats a plain BST.
+//
+// Top-down splaying (Sleator & Tarjan) restructures on the way down in one
+// pass: nodes to the left of the search path are hung onto a "left tree",
+// nodes to the right onto a "right tree", and the last node reached
+// becomes the root with the two trees as its subtrees. Two steps in the
+// same direction (zig-zig) rotate first; this is what halves the depth of
+// the path and gives the amortized bound.
+//
+// Semi-splaying restructures less: in the zig-zig case it rotates once
+// and continues below the rotated pair, so the accessed node moves only
+// about halfway up. It keeps the same amortized bound, and hot keys settle
+// more slowly. It does fewer rotations per access in principle; on the
+// benchmark below the two modes take about the same time.
+
+enum SplayMode { SPLAY_FULL, SPLAY_SEMI };
+
+// Top-down splay: returns the new root, which holds key if present,
+// otherwise the last node on key's search path.
+BSTNode* splay(BSTNode* root, int key) {
+    if (root == nullptr) return nullptr;
+    BSTNode header(0);                  // header.right / header.left collect L and R
+    BSTNode* leftMax = &header;         // rightmost node of the left tree
+    BSTNode* rightMin = &header;        // leftmost node of the right tree
+    BSTNode* t = root;
+    while (true) {
+        if (key < t->key) {
+            if (t->left == nullptr) break;
+            if (key < t->left->key) {           // zig-zig: rotate right
+                BSTNode* y = t->left;
+                t->left = y->right;
+                y->right = t;
+                t = y;
+                if (t->left == nullptr) break;
+            }
+            rightMin->left = t;                 // link t into the right tree
+            rightMin = t;
+            t = t->left;
+        } else if (key > t->key) {
+            if (t->right == nullptr) break;
+            if (key > t->right->key) {          // zig-zig: rotate left
+                BSTNode* y = t->right;
+                t->right = y->left;
+                y->left = t;
+                t = y;
+                if (t->right == nullptr) break;
+            }
+            leftMax->right = t;                 // link t into the left tree
+            leftMax = t;
+            t = t->right;
+        } else {
+            break;
+        }
+    }
+    leftMax->right = t->left;                   // reassemble
+    rightMin->left = t->right;
+    t->left = header.right;
+    t->right = header.left;
+    return t;
+}
+
+// Top-down semi-splay along key's search path, in the same single pass as
+// the search and with no extra space. The path is consumed two nodes at a
+// time: a zig-zig pair (t, c) is rotated once so c takes t's place and the
+// walk continues below c; a zig-zag pair brings the grandchild up over both
+// and the walk continues below it. Every pair of levels on the path
+// collapses to about one, so the accessed node ends up roughly halfway to
+// the root instead of at it. Returns the link holding key, or the null
+// link where key would be inserted.
+BSTNode** semiSplay(BSTNode*& root, int key) {
+    BSTNode** link = &root;
+    while (true) {
+        BSTNode* t = *link;
+        if (t == nullptr || t->key == key) return link;
+        bool tLeft = key < t->key;
+        BSTNode** cLink = tLeft ? &t->left : &t->right;
+        BSTNode* c = *cLink;
+        if (c == nullptr || c->key == key) return cLink;
+        bool cLeft = key < c->key;
+        BSTNode** gLink = cLeft ? &c->left : &c->right;
+        BSTNode* g = *gLink;
+        if (g == nullptr) return gLink;
+        if (tLeft == cLeft) {                       // zig-zig: rotate c over t
+            if (tLeft) { t->left = c->right; c->right = t; }
+            else       { t->right = c->left; c->left = t; }
+            *link = c;
+            link = gLink;                           // still c's link to g
+        } else {                                    // zig-zag: g over c and t
+            if (tLeft) { c->right = g->left; t->left = g->right; g->left = c; g->right = t; }
+            else       { c->left = g->right; t->right = g->left; g->right = c; g->left = t; }
+            *link = g;
+            if (key == g->key) return link;
+            if (key < g->key) link = tLeft ? &c->right : &t->right;
+            else              link = tLeft ? &t->left : &c->left;
+        }
+    }
+}
+
+// Search restructures the tree, so the root is passed by reference.
+// Returns the node holding key (now at or near the root), or nullptr.
+BSTNode* splaySearch(BSTNode*& root, int key, SplayMode mode = SPLAY_FULL) {
+    if (mode == SPLAY_SEMI) return *semiSplay(root, key);  // may stop short of the root
+    root = splay(root, key);
+    return (root != nullptr && root->key == key) ? root : nullptr;
+}
+
+// Insert: splay key's neighbour to the root, then split around it. In
+// semi-splay mode the new leaf goes into the null link the pass ends at.
+BSTNode* splayInsert(BSTNode* root, int key, SplayMode mode = SPLAY_FULL) {
+    if (mode == SPLAY_SEMI) {
+        BSTNode** link = semiSplay(root, key);
+        if (*link == nullptr) *link = new BSTNode(key);
+        return root;
+    }
+    if (root == nullptr) return new BSTNode(key);
+    root = splay(root, key);
+    if (root->key == key) return root;          // duplicate
+    BSTNode* node = new BSTNode(key);
+    if (key < root->key) {
+        node->left = root->left;
+        node->right = root;
+        root->left = nullptr;
+    } else {
+        node->right = root->right;
+        node->left = root;
+        root->right = nullptr;
+    }
+    return node;
+}
+
+// Delete: splay key to the root, then join its subtrees by splaying the
+// left subtree's maximum to its root (it then has no right child).
+BSTNode* splayDelete(BSTNode* root, int key) {
+    if (root == nullptr) return nullptr;
+    root = splay(root, key);
+    if (root->key != key) return root;
+    BSTNode* result;
+    if (root->left == nullptr) {
+        result = root->right;
+    } else {
+        result = splay(root->left, key);        // key > every key on the left
+        result->right = root->right;
+    }
+    delete root;
+    return result;
+}
+
+// === SECTION: Scapegoat Trees ===
+// A scapegoat tree (Galperin & Rivest) is a plain BST -- no color, size or
+// balance field in the node -- kept alpha-weight-balanced by occasional
+// rebuilding instead of rotations. Only two counters live in the tree:
+// n (current keys) and maxN (the largest n since the last full rebuild).
+//
+// Insert: a normal insert, remembering the path. If the new node lands
+// deeper than log_{1/alpha}(maxN), some ancestor is alpha-unbalanced: one
+// child holds more than alpha of its weight. Walking back up, we find that
+// "scapegoat" by counting subtree sizes on the fly (the part already
+// counted is reused, so the total work is O(size of the scapegoat's
+// subtree)) and rebuild its subtree into a perfectly balanced one in
+// linear time: flatten it to a sorted list of nodes, then relink them by
+// taking middles, as in buildBalanced. Amortized O(log n) per insert.
+//
+// Delete: a normal delete with no rebalancing (deletion is lazy). Once
+// n < alpha * maxN, rebuild the whole tree and reset maxN = n.
+// Height stays <= log_{1/alpha}(maxN) + 1. Lazy deletes can leave maxN
+// above n, but never by more than 1/alpha (n >= alpha * maxN), so the
+// height is <= log_{1/alpha}(n) + 2 = O(log n) and search is O(log n)
+// worst case.
+
+struct ScapegoatBST {
+    BSTNode* root = nullptr;
+    int n = 0;
+    int maxN = 0;
+    double alpha;
+
+    explicit ScapegoatBST(double alpha = 0.7) : alpha(alpha) {}
+};
+
+// Number of nodes in a subtree (explicit stack, so safe at any depth).
+int subtreeSize(BSTNode* root) {
+    if (root == nullptr) return 0;
+    vector<BSTNode*> stack = {root};
+    int count = 0;
+    while (!stack.empty()) {
+        BSTNode* node = stack.back();
+        stack.pop_back();
+        count++;
+        if (node->left != nullptr) stack.push_back(node->left);
+        if (node->right != nullptr) stack.push_back(node->right);
+    }
+    return count;
+}
+
+// Height in nodes (0 for an empty tree).
+int treeHeight(BSTNode* root) {
+    if (root == nullptr) return 0;
+    vector<pair<BSTNode*, int>> stack = {{root, 1}};
+    int height = 0;
+    while (!stack.empty()) {
+        auto [node, depth] = stack.back();
+        stack.pop_back();
+        height = max(height, depth);
+        if (node->left != nullptr) stack.push_back({node->left, depth + 1});
+        if (node->right != nullptr) stack.push_back({node->right, depth + 1});
+    }
+    return height;
+}
+
+// Relink nodes[lo, hi) (in key order) into a perfectly balanced subtree.
+BSTNode* relinkBalanced(vector<BSTNode*>& nodes, int lo, int hi) {
+    if (lo >= hi) return nullptr;
+    int mid = lo + (hi - lo) / 2;
+    BSTNode* node = nodes[mid];
+    node->left = relinkBalanced(nodes, lo, mid);
+    node->right = relinkBalanced(nodes, mid + 1, hi);
+    return node;
+}
+
+// Flatten/rebuild: O(size) time, reusing the existing nodes.
+BSTNode* rebuildBalanced(BSTNode* root) {
+    vector<BSTNode*> nodes, stack;
+    BSTNode* curr = root;
+    while (curr != nullptr || !stack.empty()) {      // in-order, as inOrderIterative
+        while (curr != nullptr) { stack.push_back(curr); curr = curr->left; }
+        curr = stack.back();
+        stack.pop_back();
+        nodes.push_back(curr);
+        curr = curr->right;
+    }
+    return relinkBalanced(nodes, 0, nodes.size());
+}
+
+// log_{1/alpha}(n): the deepest a node may sit in an alpha-balanced tree
+// of n nodes (insert calls it with maxN).
+int alphaHeight(const ScapegoatBST& t, int n) {
+    return (int)floor(log((double)n) / log(1.0 / t.alpha));
+}
+
+BSTNode* search(const ScapegoatBST& t, int key) {
+    return searchIterative(t.root, key);
+}
+
+bool insert(ScapegoatBST& t, int key) {
+    static thread_local vector<BSTNode**> links;   // links[i] holds the node at depth i
+    links.clear();
+    BSTNode** link = &t.root;
+    while (*link != nullptr) {
+        if (key == (*link)->key) return false;
+        links.push_back(link);
+        link = key < (*link)->key ? &(*link)->left : &(*link)->right;
+    }
+    *link = new BSTNode(key);
+    links.push_back(link);
+    t.n++;
+    t.maxN = max(t.maxN, t.n);
+
+    int depth = (int)links.size() - 1;
+    if (depth <= alphaHeight(t, t.maxN)) return true;
+
+    // Too deep: walk up to the first alpha-unbalanced ancestor.
+    int childSize = 1;
+    for (int d = depth - 1; d >= 0; d--) {
+        BSTNode* node = *links[d];
+        BSTNode* child = *links[d + 1];
+        BSTNode* sibling = child == node->left ? node->right : node->left;
+        int size = 1 + childSize + subtreeSize(sibling);
+        if (childSize > t.alpha * size) {
+            *links[d] = rebuildBalanced(node);
+            return true;
+        }
+        childSize = size;
+    }
+    return true;   // unreachable for alpha in (0.5, 1)
+}
+
+bool deleteNode(ScapegoatBST& t, int key) {
+    if (searchIterative(t.root, key) == nullptr) return false;
+    t.root = deleteNodeIterative(t.root, key);
+    t.n--;
+    if (t.n < t.alpha * t.maxN) {
+        t.root = rebuildBalanced(t.root);
+        t.maxN = t.n;
+    }
+    return true;
+}
+
+void freeTree(ScapegoatBST& t) {
+    freeTreeIterative(t.root);
+    t.root = nullptr;
+    t.n = t.maxN = 0;
+}
+
+// === SECTION: Concurrent Read-Mostly BST ===
+// Many reader threads, one writer at a time. Readers take no locks: they
+// follow atomic child links, so each step sees either the old or the new
+// subtree, never a half-built one. Writers serialize on a mutex and never
+// modify a node readers can see except by swinging a single link:
+//   - insert builds the new leaf completely, then publishes it with one
+//     release store;
+//   - delete of a node with <= 1 child swings the parent link past it;
+//   - delete of a node with two children path-copies the node (carrying
+//     its successor's key) and every node down to the successor's parent,
+//     leaving the successor out, and publishes the new subtree with one
+//     store. A reader already inside the old subtree keeps seeing an
+//     intact old version; unlinking the successor in place instead would
+//     let such a reader walk past it and miss a key that is still there.
+// Keys are immutable, so the only hazard left is freeing a node that a
+// slow reader is still standing on.
+//
+// Epoch-based reclamation: a global epoch counter; each reader announces
+// the epoch it saw before touching the tree and clears it when done. A
+// removed node is tagged with the epoch at removal time. To reclaim, the
+// writer advances the epoch and frees nodes tagged earlier than every
+// announced epoch: any reader that announced a later epoch started after
+// the node was unlinked and cannot reach it.
+
+struct ConcurrentNode {
+    const int key;
+    atomic<ConcurrentNode*> left;
+    atomic<ConcurrentNode*> right;
+
+    ConcurrentNode(int k, ConcurrentNode* l = nullptr, ConcurrentNode* r = nullptr)
+        : key(k), left(l), right(r) {}
+};
+
+class ConcurrentBST {
+    static constexpr int MAX_READERS = 128;
+    static constexpr uint64_t QUIESCENT = UINT64_MAX;
+    static constexpr size_t RECLAIM_BATCH = 256;
+
+    struct alignas(64) ReaderSlot {
+        atomic<uint64_t> epoch{QUIESCENT};
+        atomic<bool> inUse{false};
+    };
+
+    atomic<ConcurrentNode*> root{nullptr};
+    alignas(64) atomic<uint64_t> globalEpoch{1};
+    ReaderSlot slots[MAX_READERS];
+
+    mutex writeLock;                                  // guards everything below
+    vector<pair<ConcurrentNode*, uint64_t>> limbo;    // removed, not yet freed
+    int count = 0;
+
+    void retire(ConcurrentNode* node) {
+        limbo.push_back({node, globalEpoch.load()});
+        if (limbo.size() >= RECLAIM_BATCH) reclaim();
+    }
+
+    void reclaim() {
+        globalEpoch.fetch_add(1);
+        uint64_t oldest = QUIESCENT;
+        for (auto& slot : slots) oldest = min(oldest, slot.epoch.load());
+        size_t kept = 0;
+        for (auto& entry : limbo) {
+            if (entry.second < oldest) delete entry.first;
+            else limbo[kept++] = entry;
+        }
+        limbo.resize(kept);
+    }
+
+    static void freeAll(ConcurrentNode* node) {
+        while (node != nullptr) {   // rotate-and-delete, as in freeTreeIterative
+            ConcurrentNode* left = node->left.load(memory_order_relaxed);
+            if (left != nullptr) {
+                node->left.store(left->right.load(memory_order_relaxed), memory_order_relaxed);
+                left->right.store(node, memory_order_relaxed);
+                node = left;
+            } else {
+                ConcurrentNode* right = node->right.load(memory_order_relaxed);
+                delete node;
+                node = right;
+            }
+        }
+    }
+
+public:
+    ConcurrentBST() = default;
+    ConcurrentBST(const ConcurrentBST&) = delete;
+    ConcurrentBST& operator=(const ConcurrentBST&) = delete;
+
+    // Requires no readers or writers still running.
+    ~ConcurrentBST() {
+        freeAll(root.load());
+        for (auto& entry : limbo) delete entry.first;
+    }
+
+    // Each reader thread registers once, passes its id to contains(), and
+    // unregisters when done so the slot can be reused. At most MAX_READERS
+    // readers may be registered at the same time.
+    int registerReader() {
+        for (int id = 0; id < MAX_READERS; id++) {
+            bool expected = false;
+            if (slots[id].inUse.compare_exchange_strong(expected, true)) return id;
+        }
+        cerr << "ConcurrentBST: too many readers" << endl;
+        abort();
+    }
+
+    void unregisterReader(int id) {
+        slots[id].epoch.store(QUIESCENT);
+        slots[id].inUse.store(false, memory_order_release);
+    }
+
+    // Lock-free lookup. Announce the epoch, then re-check it: if a
+    // reclaim advanced the epoch in between, our announcement may have
+    // been missed, so announce again.
+    bool contains(int reader, int key) {
+        atomic<uint64_t>& slot = slots[reader].epoch;
+        uint64_t e = globalEpoch.load();
+        while (true) {
+            slot.store(e);
+            uint64_t now = globalEpoch.load();
+            if (now == e) break;
+            e = now;
+        }
+        ConcurrentNode* node = root.load(memory_order_acquire);
+        while (node != nullptr && node->key != key)
+            node = (key < node->key ? node->left : node->right).load(memory_order_acquire);
+        slot.store(QUIESCENT, memory_order_release);
+        return node != nullptr;
+    }
+
+    bool insert(int key) {
+        lock_guard<mutex> guard(writeLock);
+        atomic<ConcurrentNode*>* link = &root;
+        ConcurrentNode* node;
+        while ((node = link->load(memory_order_relaxed)) != nullptr) {
+            if (key == node->key) return false;
+            link = key < node->key ? &node->left : &node->right;
+        }
+        link->store(new ConcurrentNode(key), memory_order_release);
+        count++;
+        return true;
+    }
+
+    bool remove(int key) {
+        lock_guard<mutex> guard(writeLock);
+        atomic<ConcurrentNode*>* link = &root;
+        ConcurrentNode* node;
+        while ((node = link->load(memory_order_relaxed)) != nullptr && node->key != key)
+            link = key < node->key ? &node->left : &node->right;
+        if (node == nullptr) return false;
+
+        ConcurrentNode* left = node->left.load(memory_order_relaxed);
+        ConcurrentNode* right = node->right.load(memory_order_relaxed);
+        if (left == nullptr || right == nullptr) {
+            link->store(left != nullptr ? left : right, memory_order_release);
+            retire(node);
+        } else {
+            // Path from node->right down the left spine to the successor.
+            vector<ConcurrentNode*> path;
+            ConcurrentNode* succ = right;
+            while (ConcurrentNode* l = succ->left.load(memory_order_relaxed)) {
+                path.push_back(succ);
+                succ = l;
+            }
+            // Copy the path bottom-up; the successor's right subtree takes
+            // its place. Nothing new is visible to readers until the store.
+            ConcurrentNode* sub = succ->right.load(memory_order_relaxed);
+            for (int i = (int)path.size() - 1; i >= 0; i--)
+                sub = new ConcurrentNode(path[i]->key, sub, path[i]->right.load(memory_order_relaxed));
+            link->store(new ConcurrentNode(succ->key, left, sub), memory_order_release);
+            retire(node);
+            for (ConcurrentNode* old : path) retire(old);
+            retire(succ);
+        }
+        count--;
+        return true;
+    }
+
+    int size() {
+        lock_guard<mutex> guard(writeLock);
+        return count;
+    }
+};
+
+// Reader/writer check: even keys are loaded up front and never removed, so
+// readers must always find them and must never find keys outside the
+// loaded range; the writer churns odd keys. Returns 0 on success.
+int runConcurrentStress(int readers, int millis) {
+    const int KEYS = 1 << 16;
+    cout << "--- ConcurrentBST stress (" << readers << " readers + 1 writer, "
+         << millis << " ms) ---" << endl;
+    ConcurrentBST tree;
+    vector<int> evens;
+    for (int k = 0; k < KEYS; k += 2) evens.push_back(k);
+    unsigned int seed = 99;
+    for (int i = (int)evens.size() - 1; i > 0; i--) {
+        seed = seed * 1103515245u + 12345u;
+        swap(evens[i], evens[(seed >> 4) % (i + 1)]);
+    }
+    for (int k : evens) tree.insert(k);
+
+    atomic<bool> stop{false};
+    atomic<long long> errors{0}, lookups{0};
+    vector<thread> pool;
+    for (int r = 0; r < readers; r++) {
+        pool.emplace_back([&, r] {
+            int id = tree.registerReader();
+            unsigned int s = 1234567u * (r + 1);
+            long long n = 0, bad = 0;
+            while (!stop.load(memory_order_relaxed)) {
+                s = s * 1103515245u + 12345u;
+                int k = (int)((s >> 8) % KEYS);
+                bool found = tree.contains(id, k);
+                if (k % 2 == 0 && !found) bad++;
+                if (tree.contains(id, -1 - k) || tree.contains(id, KEYS + k)) bad++;
+                n += 3;
+            }
+            tree.unregisterReader(id);
+            lookups += n;
+            errors += bad;
+        });
+    }
+    thread writer([&] {
+        unsigned int s = 4242;
+        while (!stop.load(memory_order_relaxed)) {
+            s = s * 1103515245u + 12345u;
+            int k = (int)((s >> 8) % KEYS) | 1;
+            if ((s >> 4) & 1) tree.insert(k); else tree.remove(k);
+        }
+    });
+    this_thread::sleep_for(chrono::milliseconds(millis));
+    stop = true;
+    for (auto& t : pool) t.join();
+    writer.join();
+    cout << "  " << lookups.load() << " lookups, " << errors.load() << " errors, "
+         << tree.size() << " keys at end" << endl;
+    cout << "  " << (errors.load() == 0 ? "OK" : "FAILED") << endl;
+    return errors.load() == 0 ? 0 : 1;
+}
+
 // === MAIN ===
 
-int main() {
+int main(int argc, char** argv) {
+    bool fullBench = argc > 1 && string(argv[1]) == "--bench";
+    if (argc > 1 && string(argv[1]) == "--stress")
+        return runDegenerateStress(argc > 2 ? atoi(argv[2]) : 100000000);
+    if (argc > 1 && string(argv[1]) == "--concurrent-stress")
+        return runConcurrentStress(argc > 2 ? atoi(argv[2]) : 8, argc > 3 ? atoi(argv[3]) : 2000);
+
     cout << "========================================" << endl;
     cout << " Lecture 06: Binary Search Trees" << endl;
     cout << "========================================" << endl;
@@ -276,5 +1438,492 @@ int main() {
     printVector(result, "  Final in-order");
 
     freeTree(root);
+
+    // --- Demo 7: Arena BST ---
+    cout << "\n--- Arena BST ---" << endl;
+    {
+        BSTArena arena;
+        int aroot = NIL;
+        for (int k : keys) aroot = insert(arena, aroot, k);
+        aroot = deleteNode(arena, aroot, 20);
+        aroot = deleteNode(arena, aroot, 30);
+        aroot = deleteNode(arena, aroot, 50);
+        aroot = insert(arena, aroot, 55);   // reuses a freed slot
+        result.clear();
+        inOrder(arena, aroot, result);
+        printVector(result, "  After deleting 20, 30, 50 and inserting 55");
+        cout << "  Slots used: " << arena.nodes.size() << " for " << arena.live
+             << " live nodes (node size " << sizeof(ArenaNode) << " bytes vs "
+             << sizeof(BSTNode) << " for BSTNode)" << endl;
+        freeTree(arena, aroot);
+    }
+
+    // Benchmark: random inserts, searches and deletes, pointer vs arena
+    {
+        const int N = fullBench ? 10000000 : 1000000;
+        cout << "\n--- Pointer BST vs Arena BST (" << N << " random keys) ---" << endl;
+        vector<int> data(N);
+        unsigned int seed = 42;
+        for (int& x : data) { seed = seed * 1103515245u + 12345u; x = (int)(seed >> 1); }
+        vector<int> probes(data);
+        for (int i = N - 1; i > 0; i--) {
+            seed = seed * 1103515245u + 12345u;
+            swap(probes[i], probes[(seed >> 4) % (i + 1)]);
+        }
+
+        auto ms = [](chrono::high_resolution_clock::time_point a,
+                     chrono::high_resolution_clock::time_point b) {
+            return (long long)chrono::duration_cast<chrono::milliseconds>(b - a).count();
+        };
+
+        auto t0 = chrono::high_resolution_clock::now();
+        BSTNode* proot = nullptr;
+        for (int x : data) proot = insert(proot, x);
+        auto t1 = chrono::high_resolution_clock::now();
+        long long pfound = 0;
+        for (int x : probes) pfound += search(proot, x) != nullptr;
+        auto t2 = chrono::high_resolution_clock::now();
+        for (int i = 0; i < N / 2; i++) proot = deleteNode(proot, probes[i]);
+        auto t3 = chrono::high_resolution_clock::now();
+        freeTree(proot);
+        auto t4 = chrono::high_resolution_clock::now();
+
+        BSTArena arena;
+        int aroot = NIL;
+        auto u0 = chrono::high_resolution_clock::now();
+        for (int x : data) aroot = insert(arena, aroot, x);
+        auto u1 = chrono::high_resolution_clock::now();
+        long long afound = 0;
+        for (int x : probes) afound += search(arena, aroot, x) != NIL;
+        auto u2 = chrono::high_resolution_clock::now();
+        for (int i = 0; i < N / 2; i++) aroot = deleteNode(arena, aroot, probes[i]);
+        auto u3 = chrono::high_resolution_clock::now();
+        size_t arenaBytes = arena.bytes();
+        freeTree(arena, aroot);
+        auto u4 = chrono::high_resolution_clock::now();
+
+        cout << "  Pointer BST: insert " << ms(t0, t1) << " ms, search " << ms(t1, t2)
+             << " ms, delete half " << ms(t2, t3) << " ms, freeTree " << ms(t3, t4) << " ms" << endl;
+        cout << "  Arena BST:   insert " << ms(u0, u1) << " ms, search " << ms(u1, u2)
+             << " ms, delete half " << ms(u2, u3) << " ms, freeTree " << ms(u3, u4) << " ms"
+             << (afound == pfound ? "" : " (WRONG)") << endl;
+        cout << "  Node memory: " << sizeof(BSTNode) << " B + allocator header per pointer node, "
+             << sizeof(ArenaNode) << " B per arena node (" << arenaBytes / (1 << 20) << " MB arena)" << endl;
+    }
+
+    // --- Demo 8: Bulk loading ---
+    cout << "\n--- Bulk Load from Sorted Keys ---" << endl;
+    {
+        vector<int> sortedKeys = {10, 20, 30, 35, 40, 50, 60, 70, 80};
+        BSTNode* broot = buildBalanced(sortedKeys);
+        printTree(broot, "  ", false);
+        freeTree(broot);
+
+        BSTArena veb;
+        int vroot = buildBalancedVEB(veb, sortedKeys);
+        cout << "  vEB slot order:";
+        for (const ArenaNode& nd : veb.nodes) cout << " " << nd.key;
+        cout << " (root " << veb[vroot].key << ")" << endl;
+    }
+
+    // Benchmark: load time, then search latency on the loaded tree
+    {
+        const int N = fullBench ? 10000000 : 1000000;
+        const int SORTED_INSERTS = fullBench ? 50000 : 10000;
+        cout << "\n--- Bulk Load vs Insert (" << N << " keys) ---" << endl;
+        vector<int> sortedKeys(N);
+        for (int i = 0; i < N; i++) sortedKeys[i] = 2 * i;   // distinct, sorted
+        vector<int> shuffled(sortedKeys);
+        unsigned int seed = 7;
+        for (int i = N - 1; i > 0; i--) {
+            seed = seed * 1103515245u + 12345u;
+            swap(shuffled[i], shuffled[(seed >> 4) % (i + 1)]);
+        }
+        vector<int> probes(shuffled.begin(), shuffled.begin() + min(N, 2000000));
+
+        auto msSince = [](chrono::high_resolution_clock::time_point t) {
+            return chrono::duration<double, milli>(chrono::high_resolution_clock::now() - t).count();
+        };
+
+        // Sorted inserts degenerate into a linked list: only a small prefix
+        auto t = chrono::high_resolution_clock::now();
+        BSTNode* chain = nullptr;
+        for (int i = 0; i < SORTED_INSERTS; i++) chain = insert(chain, sortedKeys[i]);
+        double chainMs = msSince(t);
+        freeTree(chain);
+        cout << "  insert() of " << SORTED_INSERTS << " sorted keys:     "
+             << (long long)chainMs << " ms (O(n^2))" << endl;
+
+        auto report = [&](const string& name, double loadMs, auto find) {
+            auto s = chrono::high_resolution_clock::now();
+            long long found = 0;
+            for (int x : probes) found += find(x);
+            double ns = msSince(s) * 1e6 / probes.size();
+            cout << "  " << name << "load " << (long long)loadMs << " ms, search "
+                 << (long long)ns << " ns" << (found == (long long)probes.size() ? "" : " (WRONG)") << endl;
+        };
+
+        t = chrono::high_resolution_clock::now();
+        BSTNode* proot = nullptr;
+        for (int x : shuffled) proot = insert(proot, x);
+        report("insert() random order:    ", msSince(t),
+               [&](int x) { return search(proot, x) != nullptr; });
+        freeTree(proot);
+
+        t = chrono::high_resolution_clock::now();
+        proot = buildBalanced(sortedKeys);
+        report("buildBalanced (pointer):  ", msSince(t),
+               [&](int x) { return search(proot, x) != nullptr; });
+        freeTree(proot);
+
+        BSTArena arena;
+        t = chrono::high_resolution_clock::now();
+        int aroot = buildBalanced(arena, sortedKeys);
+        report("buildBalanced (arena):    ", msSince(t),
+               [&](int x) { return search(arena, aroot, x) != NIL; });
+        freeTree(arena, aroot);
+
+        BSTArena veb;
+        t = chrono::high_resolution_clock::now();
+        int vroot = buildBalancedVEB(veb, sortedKeys);
+        report("buildBalancedVEB (arena): ", msSince(t),
+               [&](int x) { return search(veb, vroot, x) != NIL; });
+        freeTree(veb, vroot);
+    }
+
+    // --- Demo 9: Iterative operations on a degenerate tree ---
+    cout << "\n--- Iterative Operations (degenerate tree) ---" << endl;
+    {
+        const int DEPTH = 1000000;   // recursive inOrder would need ~1M frames
+        BSTNode* chain = nullptr;
+        for (int k : {5, 3, 8, 1, 4}) chain = insertIterative(chain, k);
+        vector<int> a, b, c, d;
+        inOrderIterative(chain, a);
+        preOrderIterative(chain, b);
+        postOrderIterative(chain, c);
+        morrisInOrder(chain, d);
+        printVector(a, "  In-order (stack)  ");
+        printVector(b, "  Pre-order (stack) ");
+        printVector(c, "  Post-order (stack)");
+        printVector(d, "  In-order (Morris) ");
+        chain = deleteNodeIterative(chain, 5);
+        freeTreeIterative(chain);
+
+        // Descending inserts build a left spine. Each insert is O(1) because
+        // it starts from the current bottom node rather than the root; the
+        // new key is smaller, so it becomes that node's left child.
+        chain = nullptr;
+        BSTNode* bottom = nullptr;
+        for (int k = DEPTH; k > 0; k--) {
+            if (bottom == nullptr) { chain = insertIterative(chain, k); bottom = chain; }
+            else { bottom = insertIterative(bottom, k)->left; }
+        }
+        long long sum = 0;
+        morrisForEach(chain, [&](int key) { sum += key; });
+        freeTreeIterative(chain);
+        cout << "  Left spine of depth " << DEPTH << ": Morris sum " << sum
+             << (sum == (long long)DEPTH * (DEPTH + 1) / 2 ? "" : " (WRONG)")
+             << ", freed iteratively" << endl;
+    }
+
+    // --- Demo 10: Range queries ---
+    cout << "\n--- Range Queries ---" << endl;
+    {
+        BSTNode* rroot = nullptr;
+        SizedBSTNode* sroot = nullptr;
+        for (int k : keys) { rroot = insert(rroot, k); sroot = insert(sroot, k); }
+        for (int k : {33, 50, 5, 90}) {
+            BSTNode* f = floor(rroot, k);
+            BSTNode* c = ceiling(rroot, k);
+            cout << "  Key " << k << " -> floor: " << (f ? to_string(f->key) : "NONE")
+                 << ", ceiling: " << (c ? to_string(c->key) : "NONE") << endl;
+        }
+        cout << "  Keys in [25, 65]:";
+        for (RangeIterator it(rroot, 25, 65); it.valid(); it.next()) cout << " " << it.key();
+        cout << endl;
+        cout << "  rangeCount(25, 65): " << rangeCount(rroot, 25, 65)
+             << " (iterator), " << rangeCount(sroot, 25, 65) << " (sized)" << endl;
+        cout << "  rankOf(60) in sized tree: " << rankOf(sroot, 60) << endl;
+        freeTree(rroot);
+        freeTree(sroot);
+    }
+
+    // Benchmark: short range scans vs copying the tree, and count by size
+    {
+        const int N = fullBench ? 10000000 : 1000000;
+        const int Q = 100000, WIDTH = 1000;   // ~WIDTH/4 keys per range
+        cout << "\n--- Range Count (" << N << " keys, " << Q << " queries) ---" << endl;
+        BSTNode* rroot = nullptr;
+        SizedBSTNode* sroot = nullptr;
+        unsigned int seed = 11;
+        for (int i = 0; i < N; i++) {
+            seed = seed * 1103515245u + 12345u;
+            int k = (int)((seed >> 1) % (4u * N));
+            rroot = insert(rroot, k);
+            sroot = insert(sroot, k);
+        }
+        vector<int> los(Q);
+        for (int& lo : los) { seed = seed * 1103515245u + 12345u; lo = (int)((seed >> 1) % (4u * N)); }
+
+        auto t0 = chrono::high_resolution_clock::now();
+        long long viaCopy = 0;
+        for (int q = 0; q < 10; q++) {   // whole-tree copy per query: only 10
+            vector<int> all;
+            inOrderIterative(rroot, all);
+            viaCopy += upper_bound(all.begin(), all.end(), los[q] + WIDTH)
+                     - lower_bound(all.begin(), all.end(), los[q]);
+        }
+        auto t1 = chrono::high_resolution_clock::now();
+        long long viaIter = 0, viaIter10 = 0;
+        for (int q = 0; q < Q; q++) {
+            viaIter += rangeCount(rroot, los[q], los[q] + WIDTH);
+            if (q == 9) viaIter10 = viaIter;
+        }
+        auto t2 = chrono::high_resolution_clock::now();
+        long long viaSize = 0;
+        for (int q = 0; q < Q; q++) viaSize += rangeCount(sroot, los[q], los[q] + WIDTH);
+        auto t3 = chrono::high_resolution_clock::now();
+
+        auto us = [](chrono::high_resolution_clock::time_point a,
+                     chrono::high_resolution_clock::time_point b, int n) {
+            return chrono::duration<double, micro>(b - a).count() / n;
+        };
+        cout << "  inOrder copy + binary search: " << (long long)us(t0, t1, 10) << " us/query"
+             << (viaCopy == viaIter10 ? "" : " (WRONG)") << endl;
+        cout << "  RangeIterator count:          " << us(t1, t2, Q) << " us/query ("
+             << viaIter / Q << " keys/range)" << endl;
+        cout << "  Size-augmented rank count:    " << us(t2, t3, Q) << " us/query"
+             << (viaSize == viaIter ? "" : " (WRONG)") << endl;
+        freeTree(rroot);
+        freeTree(sroot);
+    }
+
+    // --- Demo 11: Concurrent read-mostly BST ---
+    // Read throughput with one writer churning keys: lock-free readers vs
+    // a reader-writer lock around the plain BST.
+    {
+        const int N = fullBench ? 4000000 : 500000;
+        const int MILLIS = fullBench ? 1000 : 200;
+        unsigned int hw = thread::hardware_concurrency();
+        cout << "\n--- Concurrent BST read scaling (" << N << " keys, 1 writer, "
+             << hw << " hardware threads) ---" << endl;
+        if (hw <= 1) cout << "  (single core: threads time-share, expect no scaling)" << endl;
+
+        vector<int> base(N);
+        unsigned int seed = 5;
+        for (int& x : base) { seed = seed * 1103515245u + 12345u; x = (int)(seed >> 1); }
+
+        ConcurrentBST ctree;
+        BSTNode* lroot = nullptr;
+        shared_mutex rw;
+        for (int x : base) { ctree.insert(x); lroot = insertIterative(lroot, x); }
+
+        // Runs `readers` threads calling read(id, key) plus one writer
+        // calling write(key, insert?) for MILLIS ms; returns reads/us.
+        auto measure = [&](int readers, auto read, auto write, auto registerReader,
+                           auto unregisterReader) {
+            atomic<bool> stop{false};
+            atomic<long long> total{0}, found{0};
+            vector<thread> pool;
+            for (int r = 0; r < readers; r++) {
+                pool.emplace_back([&, r] {
+                    int id = registerReader();
+                    unsigned int s = 77u * (r + 1);
+                    long long n = 0, hits = 0;
+                    while (!stop.load(memory_order_relaxed)) {
+                        s = s * 1103515245u + 12345u;
+                        hits += read(id, base[(s >> 8) % N]);
+                        n++;
+                    }
+                    unregisterReader(id);
+                    total += n;
+                    found += hits;
+                });
+            }
+            thread writer([&] {
+                unsigned int s = 31337;
+                while (!stop.load(memory_order_relaxed)) {
+                    s = s * 1103515245u + 12345u;
+                    int k = (int)(s >> 1) | 1;
+                    write(k, (s >> 4) & 1);
+                }
+            });
+            this_thread::sleep_for(chrono::milliseconds(MILLIS));
+            stop = true;
+            for (auto& t : pool) t.join();
+            writer.join();
+            return found.load() > 0 ? total.load() / (MILLIS * 1000.0) : 0.0;
+        };
+
+        for (int readers : {1, 2, 4, 8, 16, 32}) {
+            double lockFree = measure(readers,
+                [&](int id, int k) { return ctree.contains(id, k); },
+                [&](int k, bool ins) { if (ins) ctree.insert(k); else ctree.remove(k); },
+                [&] { return ctree.registerReader(); },
+                [&](int id) { ctree.unregisterReader(id); });
+            double locked = measure(readers,
+                [&](int, int k) { shared_lock<shared_mutex> g(rw); return searchIterative(lroot, k) != nullptr; },
+                [&](int k, bool ins) {
+                    unique_lock<shared_mutex> g(rw);
+                    lroot = ins ? insertIterative(lroot, k) : deleteNodeIterative(lroot, k);
+                },
+                [] { return 0; }, [](int) {});
+            cout << "  " << readers << " readers: lock-free " << lockFree
+                 << " reads/us, shared_mutex " << locked << " reads/us" << endl;
+            if (readers >= 4 * (int)max(1u, hw) && readers >= 8) break;
+        }
+        freeTreeIterative(lroot);
+    }
+
+    // --- Demo 12: Splay trees on skewed access ---
+    cout << "\n--- Splay Tree ---" << endl;
+    {
+        BSTNode* sroot = nullptr;
+        for (int k : keys) sroot = splayInsert(sroot, k);
+        splaySearch(sroot, 35);
+        cout << "  After inserting the demo keys and searching 35 (now the root):" << endl;
+        printTree(sroot, "    ", false);
+        sroot = splayDelete(sroot, 50);
+        result.clear();
+        inOrderIterative(sroot, result);
+        printVector(result, "  After deleting 50");
+        freeTreeIterative(sroot);
+    }
+
+    // Zipf(0.99) lookups over N keys; the hot ranks map to random keys.
+    {
+        const int N = fullBench ? 4000000 : 500000;
+        const int Q = fullBench ? 20000000 : 2000000;
+        cout << "\n--- Zipf(0.99) lookups (" << N << " keys, " << Q << " lookups) ---" << endl;
+        vector<int> keyOfRank(N);
+        for (int i = 0; i < N; i++) keyOfRank[i] = 2 * i;
+        unsigned int seed = 2024;
+        for (int i = N - 1; i > 0; i--) {
+            seed = seed * 1103515245u + 12345u;
+            swap(keyOfRank[i], keyOfRank[(seed >> 4) % (i + 1)]);
+        }
+        vector<double> cdf(N);
+        double total = 0;
+        for (int i = 0; i < N; i++) { total += 1.0 / pow(i + 1.0, 0.99); cdf[i] = total; }
+        vector<int> trace(Q);
+        for (int& k : trace) {
+            seed = seed * 1103515245u + 12345u;
+            double u = (seed >> 8) / 16777216.0 * total;
+            k = keyOfRank[lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin()];
+        }
+        vector<int> sortedKeys(N);
+        for (int i = 0; i < N; i++) sortedKeys[i] = 2 * i;
+        vector<int> insertOrder(sortedKeys);     // independent of hotness
+        for (int i = N - 1; i > 0; i--) {
+            seed = seed * 1103515245u + 12345u;
+            swap(insertOrder[i], insertOrder[(seed >> 4) % (i + 1)]);
+        }
+
+        auto nsPerLookup = [&](auto lookup) {
+            long long found = 0;
+            auto start = chrono::high_resolution_clock::now();
+            for (int k : trace) found += lookup(k);
+            auto end = chrono::high_resolution_clock::now();
+            double ns = chrono::duration<double, nano>(end - start).count() / Q;
+            return found == Q ? ns : -1.0;
+        };
+
+        BSTNode* plain = nullptr;
+        for (int k : insertOrder) plain = insertIterative(plain, k);
+        double plainNs = nsPerLookup([&](int k) { return searchIterative(plain, k) != nullptr; });
+        freeTreeIterative(plain);
+
+        BSTNode* balanced = buildBalanced(sortedKeys);
+        double balancedNs = nsPerLookup([&](int k) { return searchIterative(balanced, k) != nullptr; });
+        freeTreeIterative(balanced);
+
+        BSTNode* full = nullptr;
+        for (int k : insertOrder) full = splayInsert(full, k);
+        double fullNs = nsPerLookup([&](int k) { return splaySearch(full, k) != nullptr; });
+        freeTreeIterative(full);
+
+        BSTNode* semi = nullptr;
+        for (int k : insertOrder) semi = splayInsert(semi, k, SPLAY_SEMI);
+        double semiNs = nsPerLookup([&](int k) { return splaySearch(semi, k, SPLAY_SEMI) != nullptr; });
+        freeTreeIterative(semi);
+
+        auto show = [](const string& name, double ns) {
+            cout << "  " << name << (ns < 0 ? string("(WRONG)") : to_string((int)ns) + " ns/lookup") << endl;
+        };
+        show("Plain BST (random inserts):   ", plainNs);
+        show("Perfectly balanced BST:       ", balancedNs);
+        show("Splay tree (top-down):        ", fullNs);
+        show("Semi-splay tree:              ", semiNs);
+        if (fullNs >= plainNs && semiNs >= plainNs)
+            cout << "  (neither splay mode beats the plain BST on this trace: every lookup"
+                 << " rewrites its path, which costs more than the shorter hot paths save)" << endl;
+    }
+
+    // --- Demo 13: Scapegoat tree ---
+    cout << "\n--- Scapegoat Tree (alpha = 0.7) ---" << endl;
+    {
+        ScapegoatBST sg;
+        for (int k = 1; k <= 15; k++) insert(sg, k);        // sorted: would be a 15-deep chain
+        cout << "  After inserting 1..15 in order (height " << treeHeight(sg.root) << "):" << endl;
+        printTree(sg.root, "    ", false);
+        for (int k = 1; k <= 6; k++) deleteNode(sg, k);
+        cout << "  After deleting 1..6 (n = " << sg.n << ", maxN = " << sg.maxN
+             << ", height " << treeHeight(sg.root) << ")" << endl;
+        freeTree(sg);
+    }
+
+    // Benchmark: sorted and random loads, then lookups
+    {
+        const int N = fullBench ? 10000000 : 1000000;
+        cout << "\n--- Scapegoat vs plain BST (" << N << " keys) ---" << endl;
+        vector<int> sortedKeys(N), shuffled(N);
+        for (int i = 0; i < N; i++) sortedKeys[i] = shuffled[i] = 2 * i;
+        unsigned int seed = 17;
+        for (int i = N - 1; i > 0; i--) {
+            seed = seed * 1103515245u + 12345u;
+            swap(shuffled[i], shuffled[(seed >> 4) % (i + 1)]);
+        }
+        vector<int> probes(shuffled.begin(), shuffled.begin() + min(N, 1000000));
+
+        auto msSince = [](chrono::high_resolution_clock::time_point t) {
+            return (long long)chrono::duration<double, milli>(chrono::high_resolution_clock::now() - t).count();
+        };
+        auto probeNs = [&](auto find) {
+            auto t = chrono::high_resolution_clock::now();
+            long long found = 0;
+            for (int k : probes) found += find(k);
+            double ns = chrono::duration<double, nano>(chrono::high_resolution_clock::now() - t).count()
+                      / probes.size();
+            return found == (long long)probes.size() ? to_string((int)ns) + " ns/search" : string("(WRONG)");
+        };
+
+        for (int pass = 0; pass < 2; pass++) {
+            const vector<int>& order = pass == 0 ? sortedKeys : shuffled;
+            string name = pass == 0 ? "sorted" : "random";
+
+            ScapegoatBST sg;
+            auto t = chrono::high_resolution_clock::now();
+            for (int k : order) insert(sg, k);
+            long long loadMs = msSince(t);
+            cout << "  Scapegoat, " << name << " inserts: " << loadMs << " ms, height "
+                 << treeHeight(sg.root) << ", " << probeNs([&](int k) { return search(sg, k) != nullptr; });
+            t = chrono::high_resolution_clock::now();
+            for (int i = 0; i < N / 2; i++) deleteNode(sg, shuffled[i]);
+            cout << ", delete half " << msSince(t) << " ms (height " << treeHeight(sg.root) << ")" << endl;
+            freeTree(sg);
+
+            if (pass == 1) {
+                BSTNode* plain = nullptr;
+                t = chrono::high_resolution_clock::now();
+                for (int k : order) plain = insertIterative(plain, k);
+                loadMs = msSince(t);
+                cout << "  Plain BST, random inserts: " << loadMs << " ms, height " << treeHeight(plain)
+                     << ", " << probeNs([&](int k) { return searchIterative(plain, k) != nullptr; }) << endl;
+                freeTreeIterative(plain);
+            }
+        }
+        cout << "  (plain BST with sorted inserts degenerates to height n; see Bulk Load above)" << endl;
+    }
+
     return 0;
 }
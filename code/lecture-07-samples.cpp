@@ -8,12 +8,23 @@
 //   3. Search operation
 //   4. In-order traversal showing node colors
 //   5. Demo: insert sequence and show balanced tree height
+//   6. Ordered-map API: values, deleteMin/deleteMax/remove, rank, select,
+//      floor, ceiling, rangeCount and range listing in O(log n)
+//   7. Cache-line B+ tree with the LLRBTree interface: 448-byte nodes,
+//      SIMD search within nodes, linked leaves for range scans
+//   8. Persistent (path-copying) LLRB with O(1) reference-counted snapshots
+//   9. Join and split in O(log n); parallel union, intersection and
+//      difference built on them
 //
 // Key invariants of a Left-Leaning Red-Black BST:
 //   - No node has two red links connected to it
 //   - Every path from root to null has the same number of black links
 //   - Red links lean left (no right-leaning red links)
 //   - The root is always black
+//
+// Compile: g++ -std=c++17 -O2 -pthread [-mavx2] -o lecture-07 lecture-07-samples.cpp
+// Run:     ./lecture-07          (demo, small benchmarks)
+//          ./lecture-07 --bench  (full-size benchmarks)
 // ============================================================================
 
 #include <iostream>
@@ -21,6 +32,19 @@
 #include <string>
 #include <cmath>
 #include <queue>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
@@ -31,12 +55,14 @@ const bool BLACK = false;
 
 struct RBNode {
     int key;
+    int value;
     RBNode* left;
     RBNode* right;
     bool color;   // Color of the link from parent to this node
     int size;     // Number of nodes in subtree (for rank queries)
 
-    RBNode(int k, bool c) : key(k), left(nullptr), right(nullptr), color(c), size(1) {}
+    RBNode(int k, bool c, int v = 0)
+        : key(k), value(v), left(nullptr), right(nullptr), color(c), size(1) {}
 };
 
 // === SECTION: Helper Functions ===
@@ -106,16 +132,18 @@ void flipColors(RBNode* h) {
 //   2. If left child and left-left grandchild are both red -> rotate right
 //   3. If both children are red -> flip colors
 
-RBNode* insertHelper(RBNode* h, int key) {
+RBNode* insertHelper(RBNode* h, int key, int value) {
     // Standard BST insert at the bottom (new node is always red)
-    if (h == nullptr) return new RBNode(key, RED);
+    if (h == nullptr) return new RBNode(key, RED, value);
 
     if (key < h->key)
-        h->left = insertHelper(h->left, key);
+        h->left = insertHelper(h->left, key, value);
     else if (key > h->key)
-        h->right = insertHelper(h->right, key);
-    else
-        return h;  // Duplicate key, no insert
+        h->right = insertHelper(h->right, key, value);
+    else {
+        h->value = value;  // Duplicate key: update the value only
+        return h;
+    }
 
     // Fix-up: enforce LLRB invariants on the way back up
     if (isRed(h->right) && !isRed(h->left))       h = rotateLeft(h);
@@ -126,11 +154,286 @@ RBNode* insertHelper(RBNode* h, int key) {
     return h;
 }
 
+// === SECTION: Delete ===
+// Deletion keeps the invariant that the current node, or one of its
+// children, is red on the way down, so the node finally removed is never a
+// 2-node (removing a black leaf would break perfect black balance):
+//   - moveRedLeft / moveRedRight borrow a red link from the parent (flip)
+//     and, if the sibling is a 3-node, from the sibling (rotations);
+//   - balance() restores the LLRB invariants on the way back up.
+
+RBNode* moveRedLeft(RBNode* h) {
+    flipColors(h);
+    if (isRed(h->right->left)) {
+        h->right = rotateRight(h->right);
+        h = rotateLeft(h);
+        flipColors(h);
+    }
+    return h;
+}
+
+RBNode* moveRedRight(RBNode* h) {
+    flipColors(h);
+    if (isRed(h->left->left)) {
+        h = rotateRight(h);
+        flipColors(h);
+    }
+    return h;
+}
+
+RBNode* balance(RBNode* h) {
+    if (isRed(h->right) && !isRed(h->left))     h = rotateLeft(h);
+    if (isRed(h->left) && isRed(h->left->left))  h = rotateRight(h);
+    if (isRed(h->left) && isRed(h->right))        flipColors(h);
+    updateSize(h);
+    return h;
+}
+
+RBNode* deleteMinHelper(RBNode* h) {
+    if (h->left == nullptr) { delete h; return nullptr; }
+    if (!isRed(h->left) && !isRed(h->left->left)) h = moveRedLeft(h);
+    h->left = deleteMinHelper(h->left);
+    return balance(h);
+}
+
+RBNode* deleteMaxHelper(RBNode* h) {
+    if (isRed(h->left)) h = rotateRight(h);
+    if (h->right == nullptr) { delete h; return nullptr; }
+    if (!isRed(h->right) && !isRed(h->right->left)) h = moveRedRight(h);
+    h->right = deleteMaxHelper(h->right);
+    return balance(h);
+}
+
+// Assumes key is in the tree rooted at h.
+RBNode* removeHelper(RBNode* h, int key) {
+    if (key < h->key) {
+        if (!isRed(h->left) && !isRed(h->left->left)) h = moveRedLeft(h);
+        h->left = removeHelper(h->left, key);
+    } else {
+        if (isRed(h->left)) h = rotateRight(h);
+        if (key == h->key && h->right == nullptr) { delete h; return nullptr; }
+        if (!isRed(h->right) && !isRed(h->right->left)) h = moveRedRight(h);
+        if (key == h->key) {
+            // Replace with the successor, then delete the successor
+            RBNode* succ = h->right;
+            while (succ->left != nullptr) succ = succ->left;
+            h->key = succ->key;
+            h->value = succ->value;
+            h->right = deleteMinHelper(h->right);
+        } else {
+            h->right = removeHelper(h->right, key);
+        }
+    }
+    return balance(h);
+}
+
+// === SECTION: Join, Split and Set Operations ===
+// join(L, k, R) builds one LLRB from trees L < k < R in O(log n) by
+// comparing black heights (bh: black nodes on any path down from the
+// root). If bh(L) == bh(R), k simply becomes the root over L and R.
+// If L is taller, walk down L's right spine -- in an LLRB every right link
+// is black, so bh drops by one per step -- to the node with bh(R), and
+// hang a red k there with that node as its left subtree and R as its
+// right. This is just like inserting a red node at the bottom, and the
+// same balance() fix-ups repair the spine on the way back up. If R is
+// taller, do the same on R's left spine, stopping at a black node.
+//
+// split(T, key) splits T into keys < key, the node holding key (if any),
+// and keys > key: follow key's search path, and on the way back up join
+// each detached node with the subtree on its far side. The bh differences
+// of successive joins telescope, so the split is O(log n) in total.
+//
+// With join and split, union/intersection/difference of sets of sizes
+// m <= n take O(m log(n/m + 1)) work (Blelloch, Ferizovic & Sun): split
+// the second tree by the first tree's root key, recurse on both halves --
+// independently, so in parallel -- and join the results.
+
+struct RBPart {
+    RBNode* root = nullptr;
+    int bh = 0;
+};
+
+// Subtree of a node with black height parentBH, detached as its own tree.
+// A red root is recolored black, which adds one to its black height.
+RBPart detach(RBNode* child, int parentBH, bool parentRed) {
+    RBPart part{child, parentBH - (parentRed ? 0 : 1)};
+    if (isRed(child)) { child->color = BLACK; part.bh++; }
+    return part;
+}
+
+RBNode* joinRight(RBNode* h, int hBH, RBNode* k, RBPart r) {
+    if (hBH == r.bh) {               // h is black here: all right links are black
+        k->left = h;
+        k->right = r.root;
+        k->color = RED;
+        updateSize(k);
+        return k;
+    }
+    h->right = joinRight(h->right, hBH - 1, k, r);
+    return balance(h);
+}
+
+RBNode* joinLeft(RBNode* h, int hBH, RBNode* k, RBPart l) {
+    if (hBH == l.bh && !isRed(h)) {
+        k->left = l.root;
+        k->right = h;
+        k->color = RED;
+        updateSize(k);
+        return k;
+    }
+    h->left = joinLeft(h->left, hBH - (isRed(h) ? 0 : 1), k, l);
+    return balance(h);
+}
+
+// All keys in l < k->key < all keys in r; both roots black. Consumes all.
+RBPart join(RBPart l, RBNode* k, RBPart r) {
+    RBPart t;
+    if (l.bh == r.bh) {
+        k->left = l.root;
+        k->right = r.root;
+        k->color = BLACK;
+        updateSize(k);
+        return {k, l.bh + 1};
+    }
+    if (l.bh > r.bh) t = {joinRight(l.root, l.bh, k, r), l.bh};
+    else             t = {joinLeft(r.root, r.bh, k, l), r.bh};
+    if (isRed(t.root)) { t.root->color = BLACK; t.bh++; }
+    return t;
+}
+
+void split(RBPart t, int key, RBPart& l, RBNode*& found, RBPart& r) {
+    RBNode* h = t.root;
+    if (h == nullptr) { l = r = RBPart(); found = nullptr; return; }
+    RBPart a = detach(h->left, t.bh, isRed(h));
+    RBPart b = detach(h->right, t.bh, isRed(h));
+    if (key < h->key) {
+        RBPart rest;
+        split(a, key, l, found, rest);
+        r = join(rest, h, b);
+    } else if (key > h->key) {
+        RBPart rest;
+        split(b, key, rest, found, r);
+        l = join(a, h, rest);
+    } else {
+        l = a;
+        r = b;
+        found = h;
+    }
+}
+
+// Join without a middle key: borrow the minimum of r.
+RBPart join2(RBPart l, RBPart r) {
+    if (r.root == nullptr) return l;
+    RBNode* m = r.root;
+    while (m->left != nullptr) m = m->left;
+    RBPart empty, rest;
+    RBNode* minNode;
+    split(r, m->key, empty, minNode, rest);
+    return join(l, minNode, rest);
+}
+
+void freeNodes(RBNode* node) {
+    if (node == nullptr) return;
+    freeNodes(node->left);
+    freeNodes(node->right);
+    delete node;
+}
+
+// Below this many keys the set operations recurse on the current thread.
+const int SETOP_GRAIN = 1 << 14;
+
+// Runs left() on a new thread (if depth allows and the work is large
+// enough) while right() runs here.
+template <typename F, typename G>
+void forkJoin(int depth, int work, F left, G right) {
+    if (depth > 0 && work > SETOP_GRAIN) {
+        thread t(left);
+        right();
+        t.join();
+    } else {
+        left();
+        right();
+    }
+}
+
+// Keys in a or b; a's value wins for keys in both. Consumes both trees.
+RBPart unionParts(RBPart a, RBPart b, int depth) {
+    if (a.root == nullptr) return b;
+    if (b.root == nullptr) return a;
+    RBNode* k = a.root;
+    RBPart a1 = detach(k->left, a.bh, isRed(k)), a2 = detach(k->right, a.bh, isRed(k));
+    RBPart b1, b2, l, r;
+    RBNode* dup;
+    split(b, k->key, b1, dup, b2);
+    delete dup;
+    forkJoin(depth, nodeSize(a.root) + nodeSize(b1.root) + nodeSize(b2.root),
+             [&] { l = unionParts(a1, b1, depth - 1); },
+             [&] { r = unionParts(a2, b2, depth - 1); });
+    return join(l, k, r);
+}
+
+// Keys in both a and b, with a's values. Consumes both trees.
+RBPart intersectionParts(RBPart a, RBPart b, int depth) {
+    if (a.root == nullptr || b.root == nullptr) {
+        freeNodes(a.root);
+        freeNodes(b.root);
+        return RBPart();
+    }
+    RBNode* k = a.root;
+    RBPart a1 = detach(k->left, a.bh, isRed(k)), a2 = detach(k->right, a.bh, isRed(k));
+    RBPart b1, b2, l, r;
+    RBNode* match;
+    split(b, k->key, b1, match, b2);
+    forkJoin(depth, nodeSize(a.root) + nodeSize(b1.root) + nodeSize(b2.root),
+             [&] { l = intersectionParts(a1, b1, depth - 1); },
+             [&] { r = intersectionParts(a2, b2, depth - 1); });
+    if (match != nullptr) {
+        delete match;
+        return join(l, k, r);
+    }
+    delete k;
+    return join2(l, r);
+}
+
+// Keys in a but not in b. Consumes both trees.
+RBPart differenceParts(RBPart a, RBPart b, int depth) {
+    if (a.root == nullptr || b.root == nullptr) {
+        freeNodes(b.root);
+        return a;
+    }
+    RBNode* k = b.root;
+    RBPart b1 = detach(k->left, b.bh, isRed(k)), b2 = detach(k->right, b.bh, isRed(k));
+    RBPart a1, a2, l, r;
+    RBNode* match;
+    int work = nodeSize(a.root) + nodeSize(b.root);
+    split(a, k->key, a1, match, a2);
+    delete match;
+    delete k;
+    forkJoin(depth, work,
+             [&] { l = differenceParts(a1, b1, depth - 1); },
+             [&] { r = differenceParts(a2, b2, depth - 1); });
+    return join2(l, r);
+}
+
 // === SECTION: LLRB Tree Class ===
 
 class LLRBTree {
     RBNode* root;
 
+    RBNode* find(int key) const {
+        RBNode* curr = root;
+        while (curr != nullptr && curr->key != key)
+            curr = key < curr->key ? curr->left : curr->right;
+        return curr;
+    }
+
+    void collect(RBNode* node, int lo, int hi, vector<pair<int, int>>& out) const {
+        if (node == nullptr) return;
+        if (lo < node->key) collect(node->left, lo, hi, out);
+        if (lo <= node->key && node->key <= hi) out.push_back({node->key, node->value});
+        if (hi > node->key) collect(node->right, lo, hi, out);
+    }
+
     void inOrderHelper(RBNode* node, vector<pair<int, string>>& result) {
         if (node == nullptr) return;
         inOrderHelper(node->left, result);
@@ -140,10 +443,10 @@ class LLRBTree {
 
     int heightHelper(RBNode* node) {
         if (node == nullptr) return 0;
-        return 1 + max(heightHelper(node->left), heightHelper(node->right));
+        return 1 + std::max(heightHelper(node->left), heightHelper(node->right));
     }
 
-    int blackHeightHelper(RBNode* node) {
+    int blackHeightHelper(RBNode* node) const {
         // Count black links from root to any null (should be same for all paths)
         if (node == nullptr) return 0;
         int leftBH = blackHeightHelper(node->left);
@@ -166,15 +469,144 @@ class LLRBTree {
         delete node;
     }
 
+    RBPart part() const { return {root, blackHeightHelper(root)}; }
+
+    static int depthFor(int threads) {
+        int depth = 0;
+        while ((1 << depth) < threads) depth++;
+        return depth;
+    }
+
 public:
     LLRBTree() : root(nullptr) {}
     ~LLRBTree() { freeHelper(root); }
+    LLRBTree(const LLRBTree&) = delete;
+    LLRBTree& operator=(const LLRBTree&) = delete;
+    LLRBTree(LLRBTree&& other) : root(other.root) { other.root = nullptr; }
 
-    void insert(int key) {
-        root = insertHelper(root, key);
+    // Inserts key, or updates its value if already present.
+    void insert(int key, int value = 0) {
+        root = insertHelper(root, key, value);
         root->color = BLACK;  // Root is always black
     }
 
+    // Value stored with key, if present.
+    optional<int> get(int key) const {
+        RBNode* node = find(key);
+        if (node == nullptr) return nullopt;
+        return node->value;
+    }
+
+    // The public delete operations redden an all-black root first so the
+    // top-down descent starts with a red link to borrow from.
+    void deleteMin() {
+        if (root == nullptr) throw runtime_error("deleteMin on empty tree");
+        if (!isRed(root->left) && !isRed(root->right)) root->color = RED;
+        root = deleteMinHelper(root);
+        if (root != nullptr) root->color = BLACK;
+    }
+
+    void deleteMax() {
+        if (root == nullptr) throw runtime_error("deleteMax on empty tree");
+        if (!isRed(root->left) && !isRed(root->right)) root->color = RED;
+        root = deleteMaxHelper(root);
+        if (root != nullptr) root->color = BLACK;
+    }
+
+    // Returns false if key was not present.
+    bool remove(int key) {
+        if (find(key) == nullptr) return false;
+        if (!isRed(root->left) && !isRed(root->right)) root->color = RED;
+        root = removeHelper(root, key);
+        if (root != nullptr) root->color = BLACK;
+        return true;
+    }
+
+    int min() const {
+        if (root == nullptr) throw runtime_error("min on empty tree");
+        RBNode* node = root;
+        while (node->left != nullptr) node = node->left;
+        return node->key;
+    }
+
+    int max() const {
+        if (root == nullptr) throw runtime_error("max on empty tree");
+        RBNode* node = root;
+        while (node->right != nullptr) node = node->right;
+        return node->key;
+    }
+
+    // Number of keys strictly less than key.
+    int rank(int key) const {
+        int r = 0;
+        RBNode* node = root;
+        while (node != nullptr) {
+            if (key < node->key) {
+                node = node->left;
+            } else if (key > node->key) {
+                r += 1 + nodeSize(node->left);
+                node = node->right;
+            } else {
+                return r + nodeSize(node->left);
+            }
+        }
+        return r;
+    }
+
+    // Key of rank k (0-based): select(rank(x)) == x for every key x.
+    int select(int k) const {
+        if (k < 0 || k >= nodeSize(root)) throw out_of_range("select: rank out of range");
+        RBNode* node = root;
+        while (true) {
+            int leftSize = nodeSize(node->left);
+            if (k < leftSize) {
+                node = node->left;
+            } else if (k > leftSize) {
+                k -= leftSize + 1;
+                node = node->right;
+            } else {
+                return node->key;
+            }
+        }
+    }
+
+    // Largest key <= key.
+    optional<int> floor(int key) const {
+        optional<int> best;
+        RBNode* node = root;
+        while (node != nullptr) {
+            if (key == node->key) return node->key;
+            if (key < node->key) node = node->left;
+            else { best = node->key; node = node->right; }
+        }
+        return best;
+    }
+
+    // Smallest key >= key.
+    optional<int> ceiling(int key) const {
+        optional<int> best;
+        RBNode* node = root;
+        while (node != nullptr) {
+            if (key == node->key) return node->key;
+            if (key > node->key) node = node->right;
+            else { best = node->key; node = node->left; }
+        }
+        return best;
+    }
+
+    // Number of keys in [lo, hi], from two rank queries.
+    int rangeCount(int lo, int hi) const {
+        if (lo > hi) return 0;
+        return rank(hi) - rank(lo) + (find(hi) != nullptr ? 1 : 0);
+    }
+
+    // (key, value) pairs with lo <= key <= hi, in key order.
+    vector<pair<int, int>> range(int lo, int hi) const {
+        vector<pair<int, int>> out;
+        collect(root, lo, hi, out);
+        return out;
+    }
+
     // Search: identical to standard BST search (colors don't affect it)
     bool search(int key) {
         RBNode* curr = root;
@@ -186,6 +618,51 @@ public:
         return false;
     }
 
+    // Appends every key of right, all of which must be greater than every
+    // key here, in O(log n). right is left empty.
+    void join(LLRBTree& right) {
+        if (root != nullptr && right.root != nullptr && max() >= right.min())
+            throw invalid_argument("join: keys out of order");
+        root = join2(part(), right.part()).root;
+        right.root = nullptr;
+    }
+
+    // Moves keys >= key into the returned tree, in O(log n).
+    LLRBTree split(int key) {
+        RBPart l, r;
+        RBNode* found;
+        ::split(part(), key, l, found, r);
+        root = l.root;
+        LLRBTree upper;
+        if (found != nullptr) {
+            RBPart single{found, 1};
+            found->left = found->right = nullptr;
+            found->color = BLACK;
+            found->size = 1;
+            r = join2(single, r);
+        }
+        upper.root = r.root;
+        return upper;
+    }
+
+    // Set operations. Each consumes other (it is left empty), keeps this
+    // tree's value for keys present in both, and recurses on up to
+    // `threads` threads.
+    void unionWith(LLRBTree& other, int threads = 1) {
+        root = unionParts(part(), other.part(), depthFor(threads)).root;
+        other.root = nullptr;
+    }
+
+    void intersectWith(LLRBTree& other, int threads = 1) {
+        root = intersectionParts(part(), other.part(), depthFor(threads)).root;
+        other.root = nullptr;
+    }
+
+    void differenceWith(LLRBTree& other, int threads = 1) {
+        root = differenceParts(part(), other.part(), depthFor(threads)).root;
+        other.root = nullptr;
+    }
+
     // In-order traversal with colors
     vector<pair<int, string>> inOrderWithColors() {
         vector<pair<int, string>> result;
@@ -203,9 +680,775 @@ public:
     }
 };
 
+// === SECTION: B+ Tree ===
+// An LLRB search follows up to 2 lg n pointers, and each one is usually a
+// cache miss once the tree outgrows the cache. A B+ tree packs many keys
+// into each node, so a search touches only log_B n nodes, and the keys it
+// scans inside a node sit in a few adjacent cache lines.
+//
+// Layout: every node is 448 bytes (7 cache lines).
+//   - Leaves hold up to 48 sorted (key, value) pairs and are linked to
+//     their neighbours, so a range scan is a sequential walk along leaves.
+//   - Inner nodes hold up to 24 separators and 25 children, plus the
+//     number of keys under each child so rank/select stay O(log n), like
+//     the size field of RBNode. Separator i is <= every key in child i+1
+//     and > every key in child i.
+// Within a node we count keys below the search key with 8-wide AVX2
+// compares instead of branching through a binary search.
+//
+// All leaves are at the same depth, so the tree stores its height and the
+// code knows from the level whether a node is a leaf or an inner node.
+// Nodes other than the root are kept at least half full: inserts split a
+// full node, deletes borrow from or merge with a sibling.
+
+const int BP_LEAF_CAP = 48;
+const int BP_INNER_CAP = 24;
+const int BP_LEAF_MIN = BP_LEAF_CAP / 2;
+const int BP_INNER_MIN = BP_INNER_CAP / 2;
+
+struct alignas(64) BPNode {
+    int n = 0;   // keys in use
+};
+
+struct alignas(64) BPLeaf : BPNode {
+    int keys[BP_LEAF_CAP];
+    int values[BP_LEAF_CAP];
+    BPLeaf* prev = nullptr;
+    BPLeaf* next = nullptr;
+};
+
+struct alignas(64) BPInner : BPNode {
+    int keys[BP_INNER_CAP];
+    int counts[BP_INNER_CAP + 1];
+    BPNode* children[BP_INNER_CAP + 1];
+};
+
+// Number of keys[0..n) below key. Arrays are sized in multiples of 8, so
+// whole 8-key blocks can be loaded and the tail masked off.
+inline int countLess(const int* keys, int n, int key) {
+#ifdef __AVX2__
+    __m256i k = _mm256_set1_epi32(key);
+    int count = 0;
+    for (int i = 0; i < n; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(keys + i));
+        unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(k, v)));
+        if (n - i < 8) mask &= (1u << (n - i)) - 1;
+        count += __builtin_popcount(mask);
+    }
+    return count;
+#else
+    int count = 0;
+    for (int i = 0; i < n; i++) count += keys[i] < key;
+    return count;
+#endif
+}
+
+// Number of keys[0..n) <= key.
+inline int countLessEq(const int* keys, int n, int key) {
+#ifdef __AVX2__
+    __m256i k = _mm256_set1_epi32(key);
+    int greater = 0;
+    for (int i = 0; i < n; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(keys + i));
+        unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, k)));
+        if (n - i < 8) mask &= (1u << (n - i)) - 1;
+        greater += __builtin_popcount(mask);
+    }
+    return n - greater;
+#else
+    int count = 0;
+    for (int i = 0; i < n; i++) count += keys[i] <= key;
+    return count;
+#endif
+}
+
+class BPlusTree {
+    BPNode* root;
+    int levels;          // 1 = root is a leaf
+    long long leafCount = 1, innerCount = 0;
+
+    static BPLeaf* asLeaf(BPNode* node) { return static_cast<BPLeaf*>(node); }
+    static BPInner* asInner(BPNode* node) { return static_cast<BPInner*>(node); }
+
+    static int keysUnder(BPNode* node, int level) {
+        if (level == 0) return node->n;
+        BPInner* in = asInner(node);
+        int total = 0;
+        for (int i = 0; i <= in->n; i++) total += in->counts[i];
+        return total;
+    }
+
+    BPLeaf* findLeaf(int key) const {
+        BPNode* node = root;
+        for (int level = levels - 1; level > 0; level--) {
+            BPInner* in = asInner(node);
+            node = in->children[countLessEq(in->keys, in->n, key)];
+        }
+        return asLeaf(node);
+    }
+
+    // Returns true if key was new. If node split, splitNode is its new
+    // right sibling and splitKey the separator to insert into the parent.
+    bool insertRec(BPNode* node, int level, int key, int value,
+                   int& splitKey, BPNode*& splitNode) {
+        splitNode = nullptr;
+        if (level == 0) {
+            BPLeaf* leaf = asLeaf(node);
+            int pos = countLess(leaf->keys, leaf->n, key);
+            if (pos < leaf->n && leaf->keys[pos] == key) {
+                leaf->values[pos] = value;
+                return false;
+            }
+            if (leaf->n == BP_LEAF_CAP) {
+                BPLeaf* right = new BPLeaf();
+                leafCount++;
+                int mid = BP_LEAF_CAP / 2;
+                right->n = BP_LEAF_CAP - mid;
+                copy(leaf->keys + mid, leaf->keys + BP_LEAF_CAP, right->keys);
+                copy(leaf->values + mid, leaf->values + BP_LEAF_CAP, right->values);
+                leaf->n = mid;
+                right->next = leaf->next;
+                right->prev = leaf;
+                if (leaf->next != nullptr) leaf->next->prev = right;
+                leaf->next = right;
+                if (pos > mid) { leaf = right; pos -= mid; }
+                splitNode = right;
+            }
+            copy_backward(leaf->keys + pos, leaf->keys + leaf->n, leaf->keys + leaf->n + 1);
+            copy_backward(leaf->values + pos, leaf->values + leaf->n, leaf->values + leaf->n + 1);
+            leaf->keys[pos] = key;
+            leaf->values[pos] = value;
+            leaf->n++;
+            if (splitNode != nullptr) splitKey = asLeaf(splitNode)->keys[0];
+            return true;
+        }
+
+        BPInner* in = asInner(node);
+        int idx = countLessEq(in->keys, in->n, key);
+        int childKey;
+        BPNode* childSplit;
+        bool added = insertRec(in->children[idx], level - 1, key, value, childKey, childSplit);
+        if (added) in->counts[idx]++;
+        if (childSplit == nullptr) return added;
+
+        // Insert (childKey, childSplit) after child idx, splitting if full
+        int keys[BP_INNER_CAP + 1], counts[BP_INNER_CAP + 2];
+        BPNode* children[BP_INNER_CAP + 2];
+        int n = in->n;
+        copy(in->keys, in->keys + idx, keys);
+        keys[idx] = childKey;
+        copy(in->keys + idx, in->keys + n, keys + idx + 1);
+        copy(in->children, in->children + idx + 1, children);
+        children[idx + 1] = childSplit;
+        copy(in->children + idx + 1, in->children + n + 1, children + idx + 2);
+        copy(in->counts, in->counts + idx + 1, counts);
+        copy(in->counts + idx + 1, in->counts + n + 1, counts + idx + 2);
+        counts[idx] = keysUnder(children[idx], level - 1);
+        counts[idx + 1] = keysUnder(childSplit, level - 1);
+        n++;
+
+        if (n <= BP_INNER_CAP) {
+            in->n = n;
+            copy(keys, keys + n, in->keys);
+            copy(children, children + n + 1, in->children);
+            copy(counts, counts + n + 1, in->counts);
+            return added;
+        }
+        // Split: left keeps keys[0, mid), keys[mid] moves up, right gets the rest
+        int mid = n / 2;
+        BPInner* right = new BPInner();
+        innerCount++;
+        in->n = mid;
+        copy(keys, keys + mid, in->keys);
+        copy(children, children + mid + 1, in->children);
+        copy(counts, counts + mid + 1, in->counts);
+        right->n = n - mid - 1;
+        copy(keys + mid + 1, keys + n, right->keys);
+        copy(children + mid + 1, children + n + 1, right->children);
+        copy(counts + mid + 1, counts + n + 1, right->counts);
+        splitKey = keys[mid];
+        splitNode = right;
+        return added;
+    }
+
+    static bool underflow(BPNode* node, int level) {
+        return node->n < (level == 0 ? BP_LEAF_MIN : BP_INNER_MIN);
+    }
+
+    // Child i of p (at childLevel) is below minimum: borrow or merge.
+    void fixChild(BPInner* p, int i, int childLevel) {
+        bool hasLeft = i > 0;
+        BPNode* left = hasLeft ? p->children[i - 1] : nullptr;
+        BPNode* right = i < p->n ? p->children[i + 1] : nullptr;
+        int minKeys = childLevel == 0 ? BP_LEAF_MIN : BP_INNER_MIN;
+
+        if (childLevel == 0) {
+            BPLeaf* c = asLeaf(p->children[i]);
+            if (hasLeft && left->n > minKeys) {                      // borrow from left
+                BPLeaf* l = asLeaf(left);
+                copy_backward(c->keys, c->keys + c->n, c->keys + c->n + 1);
+                copy_backward(c->values, c->values + c->n, c->values + c->n + 1);
+                c->keys[0] = l->keys[l->n - 1];
+                c->values[0] = l->values[l->n - 1];
+                l->n--; c->n++;
+                p->keys[i - 1] = c->keys[0];
+                p->counts[i - 1]--; p->counts[i]++;
+            } else if (right != nullptr && right->n > minKeys) {     // borrow from right
+                BPLeaf* r = asLeaf(right);
+                c->keys[c->n] = r->keys[0];
+                c->values[c->n] = r->values[0];
+                c->n++;
+                copy(r->keys + 1, r->keys + r->n, r->keys);
+                copy(r->values + 1, r->values + r->n, r->values);
+                r->n--;
+                p->keys[i] = r->keys[0];
+                p->counts[i]++; p->counts[i + 1]--;
+            } else {                                                 // merge into left node
+                int j = hasLeft ? i - 1 : i;
+                BPLeaf* l = asLeaf(p->children[j]);
+                BPLeaf* r = asLeaf(p->children[j + 1]);
+                copy(r->keys, r->keys + r->n, l->keys + l->n);
+                copy(r->values, r->values + r->n, l->values + l->n);
+                l->n += r->n;
+                l->next = r->next;
+                if (r->next != nullptr) r->next->prev = l;
+                delete r;
+                leafCount--;
+                removeFromInner(p, j);
+            }
+            return;
+        }
+
+        BPInner* c = asInner(p->children[i]);
+        if (hasLeft && left->n > minKeys) {                          // rotate right through p
+            BPInner* l = asInner(left);
+            copy_backward(c->keys, c->keys + c->n, c->keys + c->n + 1);
+            copy_backward(c->children, c->children + c->n + 1, c->children + c->n + 2);
+            copy_backward(c->counts, c->counts + c->n + 1, c->counts + c->n + 2);
+            c->keys[0] = p->keys[i - 1];
+            c->children[0] = l->children[l->n];
+            c->counts[0] = l->counts[l->n];
+            c->n++;
+            p->keys[i - 1] = l->keys[l->n - 1];
+            p->counts[i - 1] -= c->counts[0];
+            p->counts[i] += c->counts[0];
+            l->n--;
+        } else if (right != nullptr && right->n > minKeys) {         // rotate left through p
+            BPInner* r = asInner(right);
+            c->keys[c->n] = p->keys[i];
+            c->children[c->n + 1] = r->children[0];
+            c->counts[c->n + 1] = r->counts[0];
+            c->n++;
+            p->keys[i] = r->keys[0];
+            p->counts[i] += r->counts[0];
+            p->counts[i + 1] -= r->counts[0];
+            copy(r->keys + 1, r->keys + r->n, r->keys);
+            copy(r->children + 1, r->children + r->n + 1, r->children);
+            copy(r->counts + 1, r->counts + r->n + 1, r->counts);
+            r->n--;
+        } else {                                                     // merge, pulling the separator down
+            int j = hasLeft ? i - 1 : i;
+            BPInner* l = asInner(p->children[j]);
+            BPInner* r = asInner(p->children[j + 1]);
+            l->keys[l->n] = p->keys[j];
+            copy(r->keys, r->keys + r->n, l->keys + l->n + 1);
+            copy(r->children, r->children + r->n + 1, l->children + l->n + 1);
+            copy(r->counts, r->counts + r->n + 1, l->counts + l->n + 1);
+            l->n += r->n + 1;
+            delete r;
+            innerCount--;
+            removeFromInner(p, j);
+        }
+    }
+
+    // Drop separator j and child j+1 of p after child j+1 was merged into child j.
+    static void removeFromInner(BPInner* p, int j) {
+        p->counts[j] += p->counts[j + 1];
+        copy(p->keys + j + 1, p->keys + p->n, p->keys + j);
+        copy(p->children + j + 2, p->children + p->n + 1, p->children + j + 1);
+        copy(p->counts + j + 2, p->counts + p->n + 1, p->counts + j + 1);
+        p->n--;
+    }
+
+    bool removeRec(BPNode* node, int level, int key) {
+        if (level == 0) {
+            BPLeaf* leaf = asLeaf(node);
+            int pos = countLess(leaf->keys, leaf->n, key);
+            if (pos == leaf->n || leaf->keys[pos] != key) return false;
+            copy(leaf->keys + pos + 1, leaf->keys + leaf->n, leaf->keys + pos);
+            copy(leaf->values + pos + 1, leaf->values + leaf->n, leaf->values + pos);
+            leaf->n--;
+            return true;
+        }
+        BPInner* in = asInner(node);
+        int idx = countLessEq(in->keys, in->n, key);
+        if (!removeRec(in->children[idx], level - 1, key)) return false;
+        in->counts[idx]--;
+        if (underflow(in->children[idx], level - 1)) fixChild(in, idx, level - 1);
+        return true;
+    }
+
+    void freeRec(BPNode* node, int level) {
+        if (level == 0) { delete asLeaf(node); return; }
+        BPInner* in = asInner(node);
+        for (int i = 0; i <= in->n; i++) freeRec(in->children[i], level - 1);
+        delete in;
+    }
+
+public:
+    BPlusTree() : root(new BPLeaf()), levels(1) {}
+    ~BPlusTree() { freeRec(root, levels - 1); }
+    BPlusTree(const BPlusTree&) = delete;
+    BPlusTree& operator=(const BPlusTree&) = delete;
+
+    // Inserts key, or updates its value if already present.
+    void insert(int key, int value = 0) {
+        int splitKey;
+        BPNode* splitNode;
+        insertRec(root, levels - 1, key, value, splitKey, splitNode);
+        if (splitNode != nullptr) {
+            BPInner* newRoot = new BPInner();
+            innerCount++;
+            newRoot->n = 1;
+            newRoot->keys[0] = splitKey;
+            newRoot->children[0] = root;
+            newRoot->children[1] = splitNode;
+            newRoot->counts[0] = keysUnder(root, levels - 1);
+            newRoot->counts[1] = keysUnder(splitNode, levels - 1);
+            root = newRoot;
+            levels++;
+        }
+    }
+
+    bool search(int key) const { return get(key).has_value(); }
+
+    optional<int> get(int key) const {
+        BPLeaf* leaf = findLeaf(key);
+        int pos = countLess(leaf->keys, leaf->n, key);
+        if (pos < leaf->n && leaf->keys[pos] == key) return leaf->values[pos];
+        return nullopt;
+    }
+
+    // Returns false if key was not present.
+    bool remove(int key) {
+        if (!removeRec(root, levels - 1, key)) return false;
+        if (levels > 1 && root->n == 0) {            // root emptied by a merge
+            BPInner* old = asInner(root);
+            root = old->children[0];
+            delete old;
+            innerCount--;
+            levels--;
+        }
+        return true;
+    }
+
+    void deleteMin() {
+        if (size() == 0) throw runtime_error("deleteMin on empty tree");
+        remove(min());
+    }
+
+    void deleteMax() {
+        if (size() == 0) throw runtime_error("deleteMax on empty tree");
+        remove(max());
+    }
+
+    int min() const {
+        if (size() == 0) throw runtime_error("min on empty tree");
+        BPNode* node = root;
+        for (int level = levels - 1; level > 0; level--) node = asInner(node)->children[0];
+        return asLeaf(node)->keys[0];
+    }
+
+    int max() const {
+        if (size() == 0) throw runtime_error("max on empty tree");
+        BPNode* node = root;
+        for (int level = levels - 1; level > 0; level--) node = asInner(node)->children[node->n];
+        return asLeaf(node)->keys[node->n - 1];
+    }
+
+    // Number of keys strictly less than key.
+    int rank(int key) const {
+        int r = 0;
+        BPNode* node = root;
+        for (int level = levels - 1; level > 0; level--) {
+            BPInner* in = asInner(node);
+            int idx = countLessEq(in->keys, in->n, key);
+            for (int j = 0; j < idx; j++) r += in->counts[j];
+            node = in->children[idx];
+        }
+        return r + countLess(asLeaf(node)->keys, node->n, key);
+    }
+
+    // Key of rank k (0-based).
+    int select(int k) const {
+        if (k < 0 || k >= size()) throw out_of_range("select: rank out of range");
+        BPNode* node = root;
+        for (int level = levels - 1; level > 0; level--) {
+            BPInner* in = asInner(node);
+            int j = 0;
+            while (k >= in->counts[j]) k -= in->counts[j++];
+            node = in->children[j];
+        }
+        return asLeaf(node)->keys[k];
+    }
+
+    // Largest key <= key.
+    optional<int> floor(int key) const {
+        BPLeaf* leaf = findLeaf(key);
+        int pos = countLessEq(leaf->keys, leaf->n, key);
+        if (pos > 0) return leaf->keys[pos - 1];
+        if (leaf->prev != nullptr) return leaf->prev->keys[leaf->prev->n - 1];
+        return nullopt;
+    }
+
+    // Smallest key >= key.
+    optional<int> ceiling(int key) const {
+        BPLeaf* leaf = findLeaf(key);
+        int pos = countLess(leaf->keys, leaf->n, key);
+        if (pos < leaf->n) return leaf->keys[pos];
+        if (leaf->next != nullptr) return leaf->next->keys[0];
+        return nullopt;
+    }
+
+    int rangeCount(int lo, int hi) const {
+        if (lo > hi) return 0;
+        return rank(hi) - rank(lo) + (search(hi) ? 1 : 0);
+    }
+
+    // (key, value) pairs with lo <= key <= hi: one descent, then a walk
+    // along the leaf chain.
+    vector<pair<int, int>> range(int lo, int hi) const {
+        vector<pair<int, int>> out;
+        BPLeaf* leaf = findLeaf(lo);
+        int pos = countLess(leaf->keys, leaf->n, lo);
+        while (leaf != nullptr) {
+            for (; pos < leaf->n; pos++) {
+                if (leaf->keys[pos] > hi) return out;
+                out.push_back({leaf->keys[pos], leaf->values[pos]});
+            }
+            leaf = leaf->next;
+            pos = 0;
+        }
+        return out;
+    }
+
+    int height() const { return levels; }
+    int size() const { return keysUnder(root, levels - 1); }
+    long long memoryBytes() const {
+        return leafCount * (long long)sizeof(BPLeaf) + innerCount * (long long)sizeof(BPInner);
+    }
+
+    // One line per level: each node as its key range and fill.
+    void printTree() const {
+        vector<BPNode*> level = {root};
+        for (int l = levels - 1; l >= 0; l--) {
+            cout << "  L" << l << ":";
+            vector<BPNode*> next;
+            for (BPNode* node : level) {
+                if (l == 0) {
+                    BPLeaf* leaf = asLeaf(node);
+                    if (leaf->n == 0) { cout << " [empty]"; continue; }
+                    cout << " [" << leaf->keys[0] << ".." << leaf->keys[leaf->n - 1] << "]";
+                } else {
+                    BPInner* in = asInner(node);
+                    cout << " [";
+                    for (int i = 0; i < in->n; i++) cout << (i ? " " : "") << in->keys[i];
+                    cout << "]";
+                    for (int i = 0; i <= in->n; i++) next.push_back(in->children[i]);
+                }
+            }
+            cout << endl;
+            level = next;
+        }
+    }
+};
+
+// === SECTION: Persistent LLRB ===
+// A persistent tree keeps old versions readable after updates. Path
+// copying: an update copies only the nodes on the search path (O(log n)),
+// and the new version shares every other subtree with the old one.
+// A snapshot is a handle on a root, so taking one is O(1).
+//
+// Nodes are reference counted: refs = number of parent nodes, snapshots
+// and the live tree pointing at the node. When an update is about to
+// modify a node, mut() checks whether it is shared. A node with refs == 1
+// is reachable only through the path we already own, so it is changed in
+// place. A shared node is copied first; the copy bumps the counts of its
+// children, which makes them shared too, so copying naturally stops at
+// the first level where the old version no longer reaches. With no
+// snapshots alive nothing is shared, and updates cost the same as in
+// LLRBTree.
+//
+// A node reachable from a snapshot is never modified, so snapshots can be
+// read from any thread without locks. Dropping the last handle on a
+// version frees the nodes only that version used.
+//
+// The PNode helpers below are overloads of the RBNode ones with a mut()
+// before every write, rather than a template shared with LLRBTree, so the
+// in-place tree the earlier sections teach is left exactly as it was.
+
+struct PNode {
+    int key;
+    int value;
+    PNode* left;
+    PNode* right;
+    bool color;
+    int size;
+    atomic<int> refs;
+
+    PNode(int k, int v, bool c)
+        : key(k), value(v), left(nullptr), right(nullptr), color(c), size(1), refs(1) {}
+};
+
+inline bool isRed(const PNode* node) { return node != nullptr && node->color == RED; }
+inline int nodeSize(const PNode* node) { return node == nullptr ? 0 : node->size; }
+
+// Drops one reference; frees the node and, transitively, any children it
+// was the last reference to.
+void release(PNode* node) {
+    if (node == nullptr || node->refs.fetch_sub(1, memory_order_acq_rel) != 1) return;
+    vector<PNode*> stack = {node};
+    while (!stack.empty()) {
+        PNode* n = stack.back();
+        stack.pop_back();
+        for (PNode* c : {n->left, n->right})
+            if (c != nullptr && c->refs.fetch_sub(1, memory_order_acq_rel) == 1) stack.push_back(c);
+        delete n;
+    }
+}
+
+// Takes ownership of one reference to node and returns an unshared node
+// with the same contents: the node itself if we held the only reference,
+// otherwise a fresh copy.
+PNode* mut(PNode* node) {
+    if (node->refs.load(memory_order_acquire) == 1) return node;
+    PNode* copy = new PNode(node->key, node->value, node->color);
+    copy->left = node->left;
+    copy->right = node->right;
+    copy->size = node->size;
+    if (copy->left != nullptr) copy->left->refs.fetch_add(1, memory_order_relaxed);
+    if (copy->right != nullptr) copy->right->refs.fetch_add(1, memory_order_relaxed);
+    release(node);
+    return copy;
+}
+
+void updateSize(PNode* node) {
+    node->size = 1 + nodeSize(node->left) + nodeSize(node->right);
+}
+
+// Rotations and flips as in the ephemeral tree; every node they write is
+// made unshared first. h itself must already be unshared.
+PNode* rotateLeft(PNode* h) {
+    PNode* x = h->right = mut(h->right);
+    h->right = x->left;
+    x->left = h;
+    x->color = h->color;
+    h->color = RED;
+    updateSize(h);
+    updateSize(x);
+    return x;
+}
+
+PNode* rotateRight(PNode* h) {
+    PNode* x = h->left = mut(h->left);
+    h->left = x->right;
+    x->right = h;
+    x->color = h->color;
+    h->color = RED;
+    updateSize(h);
+    updateSize(x);
+    return x;
+}
+
+void flipColors(PNode* h) {
+    h->color = !h->color;
+    if (h->left) { h->left = mut(h->left); h->left->color = !h->left->color; }
+    if (h->right) { h->right = mut(h->right); h->right->color = !h->right->color; }
+}
+
+PNode* balance(PNode* h) {
+    if (isRed(h->right) && !isRed(h->left))     h = rotateLeft(h);
+    if (isRed(h->left) && isRed(h->left->left))  h = rotateRight(h);
+    if (isRed(h->left) && isRed(h->right))        flipColors(h);
+    updateSize(h);
+    return h;
+}
+
+PNode* moveRedLeft(PNode* h) {
+    flipColors(h);
+    if (isRed(h->right->left)) {
+        h->right = rotateRight(h->right);
+        h = rotateLeft(h);
+        flipColors(h);
+    }
+    return h;
+}
+
+PNode* moveRedRight(PNode* h) {
+    flipColors(h);
+    if (isRed(h->left->left)) {
+        h = rotateRight(h);
+        flipColors(h);
+    }
+    return h;
+}
+
+// The recursive helpers take ownership of one reference to h and return
+// an owned reference to the updated subtree.
+PNode* insertHelper(PNode* h, int key, int value) {
+    if (h == nullptr) return new PNode(key, value, RED);
+    h = mut(h);
+    if (key < h->key)      h->left = insertHelper(h->left, key, value);
+    else if (key > h->key) h->right = insertHelper(h->right, key, value);
+    else                   h->value = value;
+    return balance(h);
+}
+
+PNode* deleteMinHelper(PNode* h) {
+    if (h->left == nullptr) { release(h); return nullptr; }
+    h = mut(h);
+    if (!isRed(h->left) && !isRed(h->left->left)) h = moveRedLeft(h);
+    h->left = deleteMinHelper(h->left);
+    return balance(h);
+}
+
+// Assumes key is in the tree rooted at h.
+PNode* removeHelper(PNode* h, int key) {
+    h = mut(h);
+    if (key < h->key) {
+        if (!isRed(h->left) && !isRed(h->left->left)) h = moveRedLeft(h);
+        h->left = removeHelper(h->left, key);
+    } else {
+        if (isRed(h->left)) h = rotateRight(h);
+        if (key == h->key && h->right == nullptr) { release(h); return nullptr; }
+        if (!isRed(h->right) && !isRed(h->right->left)) h = moveRedRight(h);
+        if (key == h->key) {
+            PNode* succ = h->right;
+            while (succ->left != nullptr) succ = succ->left;
+            h->key = succ->key;
+            h->value = succ->value;
+            h->right = deleteMinHelper(h->right);
+        } else {
+            h->right = removeHelper(h->right, key);
+        }
+    }
+    return balance(h);
+}
+
+// An immutable version of the tree. Copying a snapshot or passing it to
+// another thread is O(1); all queries are lock-free.
+class LLRBSnapshot {
+    PNode* root;
+
+    void collect(const PNode* node, int lo, int hi, vector<pair<int, int>>& out) const {
+        if (node == nullptr) return;
+        if (lo < node->key) collect(node->left, lo, hi, out);
+        if (lo <= node->key && node->key <= hi) out.push_back({node->key, node->value});
+        if (hi > node->key) collect(node->right, lo, hi, out);
+    }
+
+    int heightHelper(const PNode* node) const {
+        if (node == nullptr) return 0;
+        return 1 + std::max(heightHelper(node->left), heightHelper(node->right));
+    }
+
+public:
+    // Adopts one reference to root.
+    explicit LLRBSnapshot(PNode* root = nullptr) : root(root) {}
+    LLRBSnapshot(const LLRBSnapshot& other) : root(other.root) {
+        if (root != nullptr) root->refs.fetch_add(1, memory_order_relaxed);
+    }
+    LLRBSnapshot& operator=(LLRBSnapshot other) { swap(root, other.root); return *this; }
+    ~LLRBSnapshot() { release(root); }
+
+    optional<int> get(int key) const {
+        const PNode* node = root;
+        while (node != nullptr && node->key != key)
+            node = key < node->key ? node->left : node->right;
+        if (node == nullptr) return nullopt;
+        return node->value;
+    }
+
+    bool search(int key) const { return get(key).has_value(); }
+    int size() const { return nodeSize(root); }
+    int height() const { return heightHelper(root); }
+
+    int rank(int key) const {
+        int r = 0;
+        const PNode* node = root;
+        while (node != nullptr) {
+            if (key < node->key) {
+                node = node->left;
+            } else if (key > node->key) {
+                r += 1 + nodeSize(node->left);
+                node = node->right;
+            } else {
+                return r + nodeSize(node->left);
+            }
+        }
+        return r;
+    }
+
+    vector<pair<int, int>> range(int lo, int hi) const {
+        vector<pair<int, int>> out;
+        collect(root, lo, hi, out);
+        return out;
+    }
+};
+
+// The live, updatable tree. Updates serialize on a mutex; snapshot()
+// holds it only long enough to bump the root's count.
+class PersistentLLRB {
+    PNode* root = nullptr;
+    mutable mutex writeLock;
+
+public:
+    PersistentLLRB() = default;
+    PersistentLLRB(const PersistentLLRB&) = delete;
+    PersistentLLRB& operator=(const PersistentLLRB&) = delete;
+    ~PersistentLLRB() { release(root); }
+
+    void insert(int key, int value = 0) {
+        lock_guard<mutex> guard(writeLock);
+        root = insertHelper(root, key, value);
+        root->color = BLACK;
+    }
+
+    bool remove(int key) {
+        lock_guard<mutex> guard(writeLock);
+        const PNode* node = root;
+        while (node != nullptr && node->key != key)
+            node = key < node->key ? node->left : node->right;
+        if (node == nullptr) return false;
+        if (!isRed(root->left) && !isRed(root->right)) {
+            root = mut(root);
+            root->color = RED;
+        }
+        root = removeHelper(root, key);
+        if (root != nullptr && root->color != BLACK) {
+            root = mut(root);
+            root->color = BLACK;
+        }
+        return true;
+    }
+
+    LLRBSnapshot snapshot() const {
+        lock_guard<mutex> guard(writeLock);
+        if (root != nullptr) root->refs.fetch_add(1, memory_order_relaxed);
+        return LLRBSnapshot(root);
+    }
+
+    int size() const {
+        lock_guard<mutex> guard(writeLock);
+        return nodeSize(root);
+    }
+};
+
 // === MAIN ===
 
-int main() {
+int main(int argc, char** argv) {
+    bool fullBench = argc > 1 && string(argv[1]) == "--bench";
+
     cout << "========================================" << endl;
     cout << " Lecture 07: Red-Black BSTs (LLRB)" << endl;
     cout << "========================================" << endl;
@@ -262,5 +1505,297 @@ int main() {
     cout << "  LLRB black height:    " << tree2.blackHeight() << endl;
     cout << "  Theoretical max:      " << (int)ceil(2.0 * log2(32)) << endl;
 
+    // --- Demo 6: Ordered-map operations ---
+    cout << "\n--- Ordered Map Operations ---" << endl;
+    {
+        LLRBTree index;
+        for (int k : keys) index.insert(k, k * 100);
+        index.insert(25, 2525);                        // update in place
+        cout << "  get(25) = " << *index.get(25) << ", get(26) "
+             << (index.get(26) ? "found" : "not found") << endl;
+        cout << "  min = " << index.min() << ", max = " << index.max()
+             << ", rank(30) = " << index.rank(30) << ", select(3) = " << index.select(3) << endl;
+        cout << "  floor(33) = " << *index.floor(33) << ", ceiling(33) = " << *index.ceiling(33)
+             << ", floor(1) " << (index.floor(1) ? "exists" : "none") << endl;
+        cout << "  rangeCount(12, 40) = " << index.rangeCount(12, 40) << ":";
+        for (auto& [k, v] : index.range(12, 40)) cout << " " << k << "=" << v;
+        cout << endl;
+
+        index.deleteMin();
+        index.deleteMax();
+        index.remove(25);
+        index.remove(99);                              // absent: no-op
+        cout << "  After deleteMin, deleteMax, remove(25) (size=" << index.size()
+             << ", height=" << index.height() << "):" << endl;
+        index.printTree();
+
+        // Delete everything in random order, checking balance every 1024 removes
+        LLRBTree big;
+        const int N = 1 << 16;
+        vector<int> order(N);
+        for (int i = 0; i < N; i++) order[i] = i;
+        unsigned int seed = 3;
+        for (int i = N - 1; i > 0; i--) {
+            seed = seed * 1103515245u + 12345u;
+            swap(order[i], order[(seed >> 4) % (i + 1)]);
+        }
+        for (int k : order) big.insert(k, -k);
+        int worst = 0;
+        for (int i = 0; i < N; i++) {
+            big.remove(order[i]);
+            if (i % 1024 == 0 && big.size() > 0) worst = std::max(worst, big.height() - (int)ceil(2.0 * log2(big.size() + 1)));
+        }
+        cout << "  Inserted and removed " << N << " keys: final size " << big.size()
+             << ", height bound " << (worst <= 0 ? "held throughout" : "VIOLATED") << endl;
+    }
+
+    // --- Demo 7: B+ tree ---
+    cout << "\n--- B+ Tree (" << BP_LEAF_CAP << " keys/leaf, " << BP_INNER_CAP + 1
+         << " children/inner node, " << sizeof(BPLeaf) << "-byte nodes) ---" << endl;
+    {
+        BPlusTree bp;
+        for (int i = 1; i <= 200; i++) bp.insert(i * 5, i);
+        bp.printTree();
+        cout << "  size=" << bp.size() << ", height=" << bp.height() << ", get(500) = " << *bp.get(500)
+             << ", rank(500) = " << bp.rank(500) << ", select(99) = " << bp.select(99) << endl;
+        cout << "  floor(503) = " << *bp.floor(503) << ", ceiling(503) = " << *bp.ceiling(503)
+             << ", rangeCount(240, 260) = " << bp.rangeCount(240, 260) << endl;
+        for (int i = 1; i <= 150; i++) bp.remove(i * 5);
+        cout << "  After removing 150 keys:" << endl;
+        bp.printTree();
+    }
+
+    // Benchmark: LLRB vs B+ tree on random keys
+    {
+        const int N = fullBench ? 10000000 : 1000000;
+        const int SCANS = 100000, SCAN_WIDTH = 1000;
+        cout << "\n--- LLRBTree vs BPlusTree (" << N << " random keys) ---" << endl;
+        vector<int> data(N);
+        unsigned int seed = 8;
+        for (int& x : data) { seed = seed * 1103515245u + 12345u; x = (int)(seed >> 1); }
+        vector<int> probes(data);
+        for (int i = N - 1; i > 0; i--) {
+            seed = seed * 1103515245u + 12345u;
+            swap(probes[i], probes[(seed >> 4) % (i + 1)]);
+        }
+
+        auto mops = [](chrono::high_resolution_clock::time_point t, long long ops) {
+            double s = chrono::duration<double>(chrono::high_resolution_clock::now() - t).count();
+            return ops / s / 1e6;
+        };
+
+        // ~SCAN_WIDTH keys per scan at this key density
+        const long long span = (long long)SCAN_WIDTH * (INT_MAX / N);
+        auto run = [&](auto& tree, const string& name, auto bytesPerKey) {
+            auto t = chrono::high_resolution_clock::now();
+            for (int i = 0; i < N; i++) tree.insert(data[i], i);
+            double ins = mops(t, N);
+            t = chrono::high_resolution_clock::now();
+            long long found = 0;
+            for (int x : probes) found += tree.search(x);
+            double srch = mops(t, N);
+            t = chrono::high_resolution_clock::now();
+            long long scanned = 0;
+            for (int q = 0; q < SCANS; q++) {
+                int lo = probes[q];
+                scanned += tree.range(lo, (int)std::min<long long>(INT_MAX, lo + span)).size();
+            }
+            double scan = mops(t, scanned);
+            cout << "  " << name << "insert " << ins << " M/s, search " << srch
+                 << " M/s, range scan " << scan << " M keys/s, " << bytesPerKey() << " bytes/key"
+                 << (found == N ? "" : " (WRONG)") << endl;
+            return scanned;
+        };
+        long long s1, s2;
+        {
+            LLRBTree rb;
+            // sizeof(RBNode) plus a 16-byte-rounded malloc header
+            s1 = run(rb, "LLRBTree:  ", [] { return (double)((sizeof(RBNode) + 8 + 15) / 16 * 16); });
+        }
+        {
+            BPlusTree bp;
+            s2 = run(bp, "BPlusTree: ", [&] { return (double)bp.memoryBytes() / bp.size(); });
+        }
+        if (s1 != s2) cout << "  (WRONG: range scans differ)" << endl;
+    }
+
+    // --- Demo 8: Persistent LLRB and snapshots ---
+    cout << "\n--- Persistent LLRB ---" << endl;
+    {
+        PersistentLLRB live;
+        for (int k : keys) live.insert(k, k);
+        LLRBSnapshot v1 = live.snapshot();
+        live.insert(42, 42);
+        live.remove(10);
+        live.insert(25, 2500);                       // changes the live version only
+        LLRBSnapshot v2 = live.snapshot();
+        auto show = [](const string& name, const LLRBSnapshot& v) {
+            cout << "  " << name << " (size " << v.size() << "):";
+            for (auto& [k, val] : v.range(INT_MIN, INT_MAX)) cout << " " << k << "=" << val;
+            cout << endl;
+        };
+        show("v1", v1);
+        show("v2", v2);
+
+        // Randomized check: snapshots taken between random updates must
+        // keep matching a std::map copied at the same moment, while later
+        // updates and dropped snapshots free the versions nobody holds.
+        PersistentLLRB tree;
+        map<int, int> model;
+        vector<pair<LLRBSnapshot, map<int, int>>> saved;
+        unsigned int seed = 8;
+        int checked = 0, mismatches = 0;
+        auto matches = [](const LLRBSnapshot& snap, const map<int, int>& m) {
+            if (snap.size() != (int)m.size()) return false;
+            if (snap.range(INT_MIN, INT_MAX) != vector<pair<int, int>>(m.begin(), m.end())) return false;
+            int r = 0;
+            for (auto& [k, v] : m) if (snap.rank(k) != r++ || snap.get(k) != v) return false;
+            return true;
+        };
+        for (int step = 0; step < 20000; step++) {
+            seed = seed * 1103515245u + 12345u;
+            int key = (int)((seed >> 8) % 512);
+            if ((seed >> 4) % 3 == 0) { tree.remove(key); model.erase(key); }
+            else { tree.insert(key, step); model[key] = step; }
+            if (step % 97 == 0) saved.push_back({tree.snapshot(), model});
+            if (step % 1000 == 999) {
+                for (auto& [snap, m] : saved) { checked++; if (!matches(snap, m)) mismatches++; }
+                seed = seed * 1103515245u + 12345u;
+                for (size_t i = 0; i < saved.size(); i++)      // drop about half
+                    if ((seed >> (i % 24)) & 1) { swap(saved[i], saved.back()); saved.pop_back(); }
+            }
+        }
+        cout << "  Randomized check: 20000 updates, " << checked << " snapshot checks, "
+             << mismatches << " mismatches" << (mismatches == 0 ? "" : " (WRONG)") << endl;
+    }
+
+    // --- Demo 9: Snapshot isolation under concurrent updates ---
+    // Writer keeps inserting 0, 1, 2, ... while a reader thread takes
+    // snapshots and checks that each one is exactly a prefix 0..size-1
+    // and does not change while being read.
+    {
+        const int N = fullBench ? 2000000 : 200000;
+        cout << "\n--- Snapshot isolation under concurrent updates (" << N << " inserts) ---" << endl;
+        PersistentLLRB live;
+        atomic<bool> done{false};
+        long long snapshots = 0, bad = 0;
+        thread reader([&] {
+            while (!done.load()) {
+                LLRBSnapshot snap = live.snapshot();
+                int n = snap.size();
+                snapshots++;
+                if (n > 0 && (!snap.search(n - 1) || snap.search(n) || snap.rank(n - 1) != n - 1)) bad++;
+                if (n >= 100 && (int)snap.range(n - 100, n + 100).size() != 100) bad++;
+                if (snap.size() != n) bad++;
+            }
+        });
+        auto t = chrono::high_resolution_clock::now();
+        for (int i = 0; i < N; i++) live.insert(i, i);
+        double persistentMs = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - t).count();
+        done = true;
+        reader.join();
+
+        t = chrono::high_resolution_clock::now();
+        {
+            LLRBTree plain;
+            for (int i = 0; i < N; i++) plain.insert(i, i);
+        }
+        double plainMs = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - t).count();
+        t = chrono::high_resolution_clock::now();
+        {
+            PersistentLLRB quiet;
+            for (int i = 0; i < N; i++) quiet.insert(i, i);
+        }
+        double quietMs = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - t).count();
+
+        cout << "  " << snapshots << " snapshots checked, " << bad << " inconsistent" << endl;
+        cout << "  Inserts: LLRBTree " << (long long)plainMs << " ms, PersistentLLRB "
+             << (long long)quietMs << " ms without snapshots, " << (long long)persistentMs
+             << " ms with a concurrent snapshot reader" << endl;
+    }
+
+    // --- Demo 10: Join, split and set operations ---
+    cout << "\n--- Join / Split / Set Operations ---" << endl;
+    {
+        LLRBTree low, high;
+        for (int k = 1; k <= 10; k++) low.insert(k);
+        for (int k = 20; k <= 40; k += 2) high.insert(k);
+        low.join(high);
+        cout << "  join(1..10, 20..40 step 2): size " << low.size() << ", height " << low.height()
+             << ", black-height " << low.blackHeight() << endl;
+        LLRBTree upper = low.split(22);
+        auto keysOf = [](LLRBTree& t) {
+            string out;
+            for (auto& kv : t.range(INT_MIN, INT_MAX)) out += " " + to_string(kv.first);
+            return out;
+        };
+        cout << "  split(22): lower =" << keysOf(low) << endl;
+        cout << "             upper =" << keysOf(upper) << endl;
+
+        LLRBTree a, b, c, d;
+        for (int k = 0; k < 20; k += 2) { a.insert(k); c.insert(k); }
+        for (int k = 0; k < 20; k += 3) { b.insert(k); d.insert(k); }
+        LLRBTree a2, b2;
+        for (int k = 0; k < 20; k += 2) a2.insert(k);
+        for (int k = 0; k < 20; k += 3) b2.insert(k);
+        a.unionWith(b);
+        c.intersectWith(d);
+        a2.differenceWith(b2);
+        cout << "  evens U multiples of 3:" << keysOf(a) << endl;
+        cout << "  evens & multiples of 3:" << keysOf(c) << endl;
+        cout << "  evens - multiples of 3:" << keysOf(a2) << endl;
+    }
+
+    // Benchmark: set operations via join/split vs repeated insert/remove
+    {
+        const int N = fullBench ? 4000000 : 500000;
+        int threads = std::max(1u, thread::hardware_concurrency());
+        cout << "\n--- Set operations on " << N << " + " << N << " keys (" << threads
+             << " threads) ---" << endl;
+        vector<int> xs(N), ys(N);
+        unsigned int seed = 12;
+        for (int i = 0; i < N; i++) {
+            seed = seed * 1103515245u + 12345u;
+            xs[i] = (int)((seed >> 1) % (3u * N));
+            seed = seed * 1103515245u + 12345u;
+            ys[i] = (int)((seed >> 1) % (3u * N));
+        }
+        auto build = [](const vector<int>& v) {
+            LLRBTree t;
+            for (int x : v) t.insert(x, x);
+            return t;
+        };
+        auto ms = [](chrono::high_resolution_clock::time_point t) {
+            return (long long)chrono::duration<double, milli>(chrono::high_resolution_clock::now() - t).count();
+        };
+
+        for (int op = 0; op < 3; op++) {
+            const char* name[] = {"union       ", "intersection", "difference  "};
+            // Baseline: one insert/search/remove per key
+            LLRBTree a = build(xs), b = build(ys), out;
+            auto t = chrono::high_resolution_clock::now();
+            if (op == 0) {
+                for (auto& kv : b.range(INT_MIN, INT_MAX)) if (!a.search(kv.first)) a.insert(kv.first, kv.second);
+            } else if (op == 1) {
+                for (auto& kv : a.range(INT_MIN, INT_MAX)) if (b.search(kv.first)) out.insert(kv.first, kv.second);
+            } else {
+                for (auto& kv : b.range(INT_MIN, INT_MAX)) a.remove(kv.first);
+            }
+            long long baseMs = ms(t);
+            LLRBTree& expected = op == 1 ? out : a;
+
+            LLRBTree x = build(xs), y = build(ys);
+            t = chrono::high_resolution_clock::now();
+            if (op == 0) x.unionWith(y, threads);
+            else if (op == 1) x.intersectWith(y, threads);
+            else x.differenceWith(y, threads);
+            long long joinMs = ms(t);
+            bool same = x.range(INT_MIN, INT_MAX) == expected.range(INT_MIN, INT_MAX);
+            cout << "  " << name[op] << ": per-key " << baseMs << " ms, join-based " << joinMs
+                 << " ms (" << x.size() << " keys, height " << x.height() << ")"
+                 << (same ? "" : " (WRONG)") << endl;
+        }
+    }
+
     return 0;
 }